@@ -67,7 +67,7 @@ int exp() {
     
     // Cage
     typedef graybat::Cage<CP, GP> Cage;
-    typedef typename Cage::Event  Event;
+    typedef typename Cage::EventSet EventSet;
     typedef typename Cage::Vertex Vertex;
 
     /***************************************************************************
@@ -83,12 +83,12 @@ int exp() {
     cage.setGraph(graybat::pattern::Chain<GP>(nChainLinks));
     
     // Distribute vertices
-    cage.distribute(graybat::mapping::Filter(cage.comm.getGlobalContext().getVAddr() % 3));
+    cage.distribute(graybat::mapping::Filter(cage.comm->getGlobalContext().getVAddr() % 3));
 
     /***************************************************************************
      * Run Simulation
      ****************************************************************************/
-    std::vector<Event> events;
+    EventSet events;
 
     std::array<unsigned, 1> input {{0}};
     std::array<unsigned, 1> output {{0}};
@@ -102,28 +102,25 @@ int exp() {
 
         if(v == entry){
             v.spread(input, events);
-            std::cout << "Input: " << input[0] << " " << cage.comm.getGlobalContext().getVAddr() << std::endl;
+            std::cout << "Input: " << input[0] << " " << cage.comm->getGlobalContext().getVAddr() << std::endl;
         }
 
         if(v == exit){
             v.collect(output);
-            std::cout << "Output: " << output[0] << " " << cage.comm.getGlobalContext().getVAddr() << std::endl;
+            std::cout << "Output: " << output[0] << " " << cage.comm->getGlobalContext().getVAddr() << std::endl;
         }
 
         if(v != entry and v != exit){
             v.collect(intermediate);
             inc(intermediate[0]);
-            std::cout << "Increment: " << intermediate[0] << " " << cage.comm.getGlobalContext().getVAddr() << std::endl;
+            std::cout << "Increment: " << intermediate[0] << " " << cage.comm->getGlobalContext().getVAddr() << std::endl;
             v.spread(intermediate, events);
 	    
         }
 	
     }
 
-    for(unsigned i = 0; i < events.size(); ++i){
-        events.back().wait();
-        events.pop_back();
-    }
+    events.waitAll();
     
     return 0;
 
@@ -69,7 +69,7 @@ int exp() {
     
     // Cage
     typedef graybat::Cage<CP, GP> Cage;
-    typedef typename Cage::Event  Event;
+    typedef typename Cage::EventSet EventSet;
     typedef typename Cage::Vertex Vertex;
     typedef typename Vertex::VertexProperty VertexProperty;
 
@@ -97,7 +97,7 @@ nn     *************************************************************************
     /***************************************************************************
      * Run Simulation
      ****************************************************************************/
-    std::vector<Event> events;
+    EventSet events;
 
     std::array<unsigned, 1> input {{0}};
     std::array<unsigned, 1> output {{0}};
@@ -126,10 +126,7 @@ nn     *************************************************************************
 	
     }
 
-    for(unsigned i = 0; i < events.size(); ++i){
-	events.back().wait();
-	events.pop_back();
-    }
+    events.waitAll();
     
     return 0;
 
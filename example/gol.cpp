@@ -123,7 +123,7 @@ int gol(const unsigned nCells, const unsigned nTimeSteps ) {
     
     // Cage
     typedef graybat::Cage<CP, GP> Cage;
-    typedef typename Cage::Event  Event;
+    typedef typename Cage::EventSet EventSet;
     typedef typename Cage::Vertex Vertex;
 
     /***************************************************************************
@@ -144,7 +144,7 @@ int gol(const unsigned nCells, const unsigned nTimeSteps ) {
     /***************************************************************************
      * Run Simulation
      ****************************************************************************/
-    std::vector<Event> events;   
+    EventSet events;   
     std::vector<unsigned> golDomain(grid.getVertices().size(), 0); 
     Vertex root = grid.getVertex(0);
 
@@ -157,7 +157,6 @@ int gol(const unsigned nCells, const unsigned nTimeSteps ) {
 	}
 	
 	// Send cell state to neighbor cells
-	std::vector<Event> es;	 
 	for(Vertex &cell : grid.hostedVertices){
 	    cell.spread(cell().isAlive, events);
 	}
@@ -169,10 +168,7 @@ int gol(const unsigned nCells, const unsigned nTimeSteps ) {
 	}
 
 	// Wait to finish events
-	for(unsigned i = 0; i < events.size(); ++i){
-	    events.back().wait();
-	    events.pop_back();
-	}
+	events.waitAll();
 
 	// Gather state by vertex with id = 0
 	for(Vertex &cell: grid.hostedVertices){
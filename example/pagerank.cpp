@@ -60,7 +60,7 @@ int exp() {
     
     // Cage
     typedef graybat::Cage<CP, GP> Cage;
-    typedef typename Cage::Event  Event;
+    typedef typename Cage::EventSet EventSet;
     typedef typename Cage::Vertex Vertex;
     typedef typename Cage::Edge   Edge;    
 
@@ -82,7 +82,7 @@ int exp() {
     /***************************************************************************
      * Run Simulation
      ****************************************************************************/
-    std::vector<Event> events;
+    EventSet events;
     size_t const nIterations = 20;
     float const dampingFactor = 0.5;
 
@@ -110,10 +110,7 @@ int exp() {
             v().pageRank[0] = (1 - dampingFactor) + dampingFactor * relativePageRankSum;
         }
 
-        for(unsigned i = 0; i < events.size(); ++i){
-            events.back().wait();
-            events.pop_back();
-        }
+        events.waitAll();
     }
 
     // Print page final page rank
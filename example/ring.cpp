@@ -67,7 +67,7 @@ int exp() {
     
     // Cage
     typedef graybat::Cage<CP, GP> Cage;
-    typedef typename Cage::Event  Event;
+    typedef typename Cage::EventSet EventSet;
     typedef typename Cage::Vertex Vertex;
 
     /***************************************************************************
@@ -91,7 +91,7 @@ int exp() {
     /***************************************************************************
      * Run Simulation
      ****************************************************************************/
-    std::vector<Event> events;
+    EventSet events;
 
     std::array<std::tuple<unsigned, std::string>, 1> input{{std::make_tuple(0, "hello")}};
     std::array<std::tuple<unsigned, std::string>, 1> output;
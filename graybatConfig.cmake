@@ -82,3 +82,11 @@ set(graybat_LIBRARIES ${graybat_LIBRARIES} ${MPI_CXX_LIBRARIES})
 ################################################################################
 find_package(Threads MODULE)
 set(graybat_LIBRARIES ${graybat_LIBRARIES} ${CMAKE_THREAD_LIBS_INIT})
+
+################################################################################
+# Find RT (shm_open for the shared memory communication policy)
+################################################################################
+find_library(RT_LIBRARY NAMES rt librt.so.1)
+if(RT_LIBRARY)
+  set(graybat_LIBRARIES ${graybat_LIBRARIES} ${RT_LIBRARY})
+endif()
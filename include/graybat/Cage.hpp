@@ -32,11 +32,19 @@
 #include <tuple>     /* std::tie */
 #include <memory>    /* std::shared_memory */
 #include <sstream>   /* std::stringstream */
+#include <array>     /* std::array */
+#include <cstring>   /* std::memcpy */
+#include <set>       /* std::set */
+#include <mutex>     /* std::mutex, std::lock_guard */
+#include <typeinfo>  /* typeid */
+#include <typeindex> /* std::type_index */
 
 // GRAYBAT
 #include <graybat/utils/exclusivePrefixSum.hpp> /* exclusivePrefixSum */
 #include <graybat/Vertex.hpp>                   /* CommunicationVertex */
 #include <graybat/Edge.hpp>                     /* CommunicationEdge */
+#include <graybat/Neighborhood.hpp>             /* CommunicationNeighborhood */
+#include <graybat/Window.hpp>                   /* CommunicationWindow */
 #include <graybat/pattern/None.hpp>             /* graybatt::pattern::None */
 #include <graybat/communicationPolicy/Traits.hpp>
 #include <graybat/graphPolicy/Traits.hpp>
@@ -67,10 +75,14 @@ namespace graybat {
         using VAddr               = graybat::communicationPolicy::VAddr<CommunicationPolicy>;
         using Context             = graybat::communicationPolicy::Context<CommunicationPolicy>;
         using Event               = graybat::communicationPolicy::Event<CommunicationPolicy>;
+        using EventSet            = graybat::communicationPolicy::EventSet<CommunicationPolicy>;
         using CPConfig            = graybat::communicationPolicy::Config<CommunicationPolicy>;
         using ContextID           = graybat::communicationPolicy::ContextID<CommunicationPolicy>;
+        using Barrier             = graybat::communicationPolicy::Barrier<CommunicationPolicy>;
         using Edge                = graybat::CommunicationEdge<Cage>;
         using Vertex              = graybat::CommunicationVertex<Cage>;
+        using Neighborhood        = graybat::CommunicationNeighborhood<Cage>;
+        using Window              = graybat::CommunicationWindow<Cage>;
 
         using EdgeDescription     = graybat::graphPolicy::EdgeDescription<GraphPolicy>;
         using GraphDescription    = graybat::graphPolicy::GraphDescription<GraphPolicy>;
@@ -266,6 +278,14 @@ namespace graybat {
         template<typename T>
         void send(const Edge &edge, const T &data, std::vector<Event> &events);
 
+        /**
+         * @brief Asynchron transmission of *data* to the *destVertex* on *edge*.
+         *        The send event is added to *events*, which can wait for
+         *        all of its events at once.
+         */
+        template<typename T>
+        void send(const Edge &edge, const T &data, EventSet &events);
+
         /**
          * @brief Synchron receive of *data* from the *srcVertex* on *edge*.
          *
@@ -292,12 +312,22 @@ namespace graybat {
         template<typename T>
         void recv(const Edge &edge, T &data, std::vector<Event> &events);
 
+        template<typename T>
+        void recv(const Edge &edge, T &data, EventSet &events);
+
         /** @} */
 
         /**********************************************************************//**
          *
          * @name Collective Communication Operations 
          *
+         * Every hosted vertex of a peer takes part in a collective
+         * operation. The operation is started when the last hosted
+         * vertex called it, thus results are only available to the
+         * other hosted vertices from then on. The hosted vertices may
+         * call it from different threads if the communication policy
+         * was configured for concurrent communication.
+         *
          * @{
          *
          **************************************************************************/
@@ -309,6 +339,20 @@ namespace graybat {
         template<typename T_Data, typename T_Recv, typename Op>
         void allReduce(const Vertex &srcVertex, Op op, const std::vector<T_Data> sendData, T_Recv &recvData);
 
+        /**
+         * @brief Reduces *sendData* of all vertices with the commutative *op*
+         *        and hands every vertex its own block of the result.
+         *
+         * @param[in]  srcVertex Vertex that contributes *sendData*
+         * @param[in]  op        Commutative binary operator
+         * @param[in]  sendData  One block of recvData.size() elements per vertex of
+         *                       the graph, ordered by vertex id.
+         * @param[out] recvData  Block srcVertex.id of the reduced sendData.
+         *
+         */
+        template<typename T_Data, typename T_Recv, typename Op>
+        void reduceScatter(const Vertex &srcVertex, Op op, const std::vector<T_Data> sendData, T_Recv &recvData);
+
         template<typename T_Send, typename T_Recv>
         void gather(const Vertex &rootVertex, const Vertex &srcVertex, const T_Send sendData, T_Recv &recvData,
                     const bool reorder);
@@ -328,6 +372,9 @@ namespace graybat {
         template<typename T>
         void spread(const Vertex &vertex, const T &data, std::vector<Event> &events);
 
+        template<typename T>
+        void spread(const Vertex &vertex, const T &data, EventSet &events);
+
         /**
          * @brief Spread data from a vertex to all adjacent vertices
          *        connected by an outgoing edge (sync).
@@ -354,6 +401,149 @@ namespace graybat {
 
         void synchronize();
 
+        /**
+         * @brief Split-phase barrier: signals that this peer reached the
+         *        end of its superstep without waiting for the others.
+         *        The returned barrier is ready() once all peers arrived
+         *        and its wait() blocks until then. Local work can be done
+         *        in between.
+         */
+        Barrier arrive();
+
+
+        /** @} */
+
+        /**********************************************************************//**
+         *
+         * @name Persistent Communication Operations
+         *
+         * Only available when the communication policy provides
+         * persistent channels (BMPI). Channels are created once after
+         * distribute() and started every iteration.
+         *
+         * @{
+         *
+         **************************************************************************/
+
+        /**
+         * @brief Creates a persistent send of *data* on *edge* and adds
+         *        it to *channels*. *data* has to stay valid as long as
+         *        the channels exist.
+         */
+        template<typename T, typename T_Channels>
+        void sendInit(const Edge &edge, const T &data, T_Channels &channels);
+
+        /**
+         * @brief Creates a persistent receive into *data* on *edge* and
+         *        adds it to *channels*.
+         */
+        template<typename T, typename T_Channels>
+        void recvInit(const Edge &edge, T &data, T_Channels &channels);
+
+        /**
+         * @brief Creates persistent sends of *data* on all outgoing
+         *        edges of *vertex* and adds them to *channels*.
+         */
+        template<typename T, typename T_Channels>
+        void spreadInit(const Vertex &vertex, const T &data, T_Channels &channels);
+
+        /** @} */
+
+        /**********************************************************************//**
+         *
+         * @name Neighborhood Communication Operations
+         *
+         * Only available when the communication policy provides
+         * neighborhood collectives (BMPI). A whole spread/collect
+         * superstep of all hosted vertices becomes one collective
+         * on the peer level communication graph.
+         *
+         * @{
+         *
+         **************************************************************************/
+
+        /**
+         * @brief Creates the neighborhood of this peer from the
+         *        distributed graph. Has to be called by all peers
+         *        after distribute().
+         */
+        auto createNeighborhood() -> Neighborhood;
+
+        /**
+         * @brief Spreads the data of every hosted vertex along its
+         *        outgoing edges and collects the data of the incoming
+         *        edges of every hosted vertex.
+         *
+         * @param[in]  sendData One block of equal size for each hosted
+         *                      vertex, in the order of hostedVertices.
+         * @param[out] recvData One block of equal size for each incoming
+         *                      edge, ordered by hosted vertex and then
+         *                      as returned by getInEdges.
+         */
+        template<typename T_Send, typename T_Recv>
+        void exchange(Neighborhood &neighborhood, const T_Send &sendData, T_Recv &recvData);
+
+        /**
+         * @brief Non-blocking version of exchange, finished by
+         *        neighborhood.wait(). *recvData* has to stay valid
+         *        until then.
+         */
+        template<typename T_Send, typename T_Recv>
+        void asyncExchange(Neighborhood &neighborhood, const T_Send &sendData, T_Recv &recvData);
+
+        /** @} */
+
+        /**********************************************************************//**
+         *
+         * @name One-Sided Communication Operations
+         *
+         * Only available when the communication policy provides
+         * one-sided windows (BMPI). Messages of fixed size are put
+         * straight into the slot of their edge at the target peer,
+         * a fence or PSCW epoch takes the place of receive matching.
+         *
+         * @{
+         *
+         **************************************************************************/
+
+        /**
+         * @brief Creates a window with a slot of *nElements* elements of
+         *        type T_Value for every incoming edge of the hosted
+         *        vertices. Has to be called by all peers after distribute().
+         */
+        template<typename T_Value>
+        auto createWindow(std::size_t nElements) -> Window;
+
+        /**
+         * @brief Puts *data* into the slot of *edge* at the peer hosting
+         *        the target vertex. *data* has to stay valid until the
+         *        epoch is closed.
+         */
+        template<typename T>
+        void send(const Edge &edge, const T &data, Window &window);
+
+        /**
+         * @brief Copies the slot of the incoming *edge* into *data*.
+         *        Holds the data put during the last closed epoch.
+         */
+        template<typename T>
+        void recv(const Edge &edge, T &data, Window &window);
+
+        /**
+         * @brief Closes the current epoch of all peers and opens the next.
+         */
+        void fence(Window &window);
+
+        /**
+         * @brief Opens an epoch that only synchronizes with the peers
+         *        connected to this peer by an edge (post/start).
+         */
+        void openEpoch(Window &window);
+
+        /**
+         * @brief Closes the epoch opened by openEpoch (complete/wait).
+         */
+        void closeEpoch(Window &window);
 
         /** @} */
 
@@ -379,12 +569,43 @@ namespace graybat {
         // List of vertices of the hosts
         std::map<VAddr, std::vector<Vertex> > peerMap;
 
+        /***************************************************************************
+         *
+         * COLLECTIVES
+         *
+         ***************************************************************************/
+        // Intermediate state of the collective operations of the hosted vertices
+        std::map<std::type_index, std::shared_ptr<void> > collectiveStates;
+        std::unique_ptr<std::mutex> collectiveMutex{new std::mutex};
+
+        /**
+         * @brief Returns the state of type *T_State* of this cage, it is
+         *        default constructed on first use. The collectiveMutex
+         *        has to be held by the caller.
+         */
+        template<typename T_State>
+        T_State& collectiveState();
+
         /**
          * @brief Reorders data received from vertices into vertex id order.
          *
          */
         template<class T>
         void reorder(const std::vector<T> &data, const std::vector<unsigned> &recvCount, std::vector<T> &dataReordered);
+
+        /**
+         * @brief Packs the blocks of *sendData* per destination peer and
+         *        sizes the buffers and counts of a neighborhood exchange.
+         */
+        template<typename T_Send, typename T_Recv>
+        void pack(Neighborhood &neighborhood, const T_Send &sendData, const T_Recv &recvData);
+
+        /**
+         * @brief Copies the blocks received per source peer to their
+         *        incoming edge slots of *recvData*.
+         */
+        template<typename T_Recv>
+        void unpack(Neighborhood &neighborhood, T_Recv &recvData);
     };
 
     //!
@@ -557,13 +778,15 @@ namespace graybat {
             std::array<unsigned, 1> nVertices{{static_cast<unsigned>(vertices.size())}};
             std::vector<unsigned> vertexIDs;
 
+            EventSet events;
+
             std::for_each(vertices.begin(), vertices.end(), [&vertexIDs](Vertex v) { vertexIDs.push_back(v.id); });
 
             // Send hostedVertices to all other peers
             for (auto const &vAddr : graphContext) {
                 assert(nVertices[0] != 0);
-                comm->asyncSend(vAddr, 0, graphContext, nVertices);
-                comm->asyncSend(vAddr, 0, graphContext, vertexIDs);
+                events.push_back(comm->asyncSend(vAddr, 0, graphContext, nVertices));
+                events.push_back(comm->asyncSend(vAddr, 0, graphContext, vertexIDs));
             }
 
             // Recv hostedVertices from all other peers
@@ -581,6 +804,8 @@ namespace graybat {
                 peerMap[vAddr] = remoteVertices;
             }
 
+            events.waitAll();
+
         }
 
     }
@@ -605,7 +830,11 @@ namespace graybat {
     auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
     getHostedVertices(const VAddr &vAddr)
     -> std::vector<Vertex> {
-        return peerMap[vAddr];
+        auto it = peerMap.find(vAddr);
+        if (it != peerMap.end()) {
+            return it->second;
+        }
+        return std::vector<Vertex>();
 
     }
 
@@ -655,6 +884,15 @@ namespace graybat {
         events.push_back(comm->asyncSend(destVAddr, edge.id, graphContext, data));
     }
 
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    send(const Edge &edge, const T &data, EventSet &events)
+    -> void {
+        VAddr destVAddr = locateVertex(edge.target);
+        events.push_back(comm->asyncSend(destVAddr, edge.id, graphContext, data));
+    }
+
     template<typename T_CommunicationPolicy, typename T_GraphPolicy>
     template<typename T>
     auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
@@ -688,6 +926,15 @@ namespace graybat {
         events.push_back(comm->asyncRecv(srcVAddr, edge.id, graphContext, data));
     }
 
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    recv(const Edge &edge, T &data, EventSet &events)
+    -> void {
+        VAddr srcVAddr = locateVertex(edge.source);
+        events.push_back(comm->asyncRecv(srcVAddr, edge.id, graphContext, data));
+    }
+
 
     //!
     //! Collective Communication Operations
@@ -699,10 +946,19 @@ namespace graybat {
     reduce(const Vertex &rootVertex, const Vertex &srcVertex, Op op, const std::vector<T_Data> sendData,
            std::vector<T_Data> &recvData)
     -> void {
-        static std::vector<T_Data> reduce;
-        static std::vector<T_Data> *rootRecvData;
-        static unsigned vertexCount = 0;
-        static bool hasRootVertex = false;
+        struct State {
+            std::vector<T_Data> reduce;
+            std::vector<T_Data> *rootRecvData = nullptr;
+            unsigned vertexCount = 0;
+            bool hasRootVertex = false;
+        };
+
+        std::lock_guard<std::mutex> lock(*collectiveMutex);
+        State &state = collectiveState<State>();
+        std::vector<T_Data> &reduce = state.reduce;
+        std::vector<T_Data> *&rootRecvData = state.rootRecvData;
+        unsigned &vertexCount = state.vertexCount;
+        bool &hasRootVertex = state.hasRootVertex;
 
         VAddr rootVAddr = locateVertex(rootVertex);
         VAddr srcVAddr = locateVertex(srcVertex);
@@ -737,6 +993,8 @@ namespace graybat {
 
             reduce.clear();
             vertexCount = 0;
+            hasRootVertex = false;
+            rootRecvData = nullptr;
         }
         assert(vertexCount <= vertices.size());
 
@@ -748,9 +1006,17 @@ namespace graybat {
     allReduce(const Vertex &srcVertex, Op op, const std::vector<T_Data> sendData, T_Recv &recvData)
     -> void {
 
-        static std::vector<T_Data> reduce;
-        static unsigned vertexCount = 0;
-        static std::vector<T_Recv *> recvDatas;
+        struct State {
+            std::vector<T_Data> reduce;
+            unsigned vertexCount = 0;
+            std::vector<T_Recv *> recvDatas;
+        };
+
+        std::lock_guard<std::mutex> lock(*collectiveMutex);
+        State &state = collectiveState<State>();
+        std::vector<T_Data> &reduce = state.reduce;
+        unsigned &vertexCount = state.vertexCount;
+        std::vector<T_Recv *> &recvDatas = state.recvDatas;
 
         VAddr srcVAddr = locateVertex(srcVertex);
         Context context = graphContext;
@@ -780,11 +1046,75 @@ namespace graybat {
 
 
             reduce.clear();
+            recvDatas.clear();
             vertexCount = 0;
         }
         assert(vertexCount <= vertices.size());
     }
 
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T_Data, typename T_Recv, typename Op>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    reduceScatter(const Vertex &srcVertex, Op op, const std::vector<T_Data> sendData, T_Recv &recvData)
+    -> void {
+
+        struct State {
+            std::vector<T_Data> reduce;
+            std::map<VertexID, T_Recv *> recvDatas;
+        };
+
+        std::lock_guard<std::mutex> lock(*collectiveMutex);
+        State &state = collectiveState<State>();
+        std::vector<T_Data> &reduce = state.reduce;
+        std::map<VertexID, T_Recv *> &recvDatas = state.recvDatas;
+
+        Context context = graphContext;
+        const size_t nElements = recvData.size();
+
+        recvDatas[srcVertex.id] = &recvData;
+
+        // Reduce locally
+        if (reduce.empty()) {
+            reduce = sendData;
+        }
+        else {
+            std::transform(reduce.begin(), reduce.end(), sendData.begin(), reduce.begin(), op);
+        }
+
+        // Finally start reduction
+        if (recvDatas.size() == hostedVertices.size()) {
+
+            // Order the blocks by the peers that host their vertex
+            std::vector<T_Data> packed;
+            std::vector<unsigned> recvCount;
+            packed.reserve(reduce.size());
+            for (auto const &vAddr : context) {
+                const std::vector<Vertex> vertices = getHostedVertices(vAddr);
+                for (const Vertex &v : vertices) {
+                    packed.insert(packed.end(),
+                                  reduce.begin() + v.id * nElements,
+                                  reduce.begin() + (v.id + 1) * nElements);
+                }
+                recvCount.push_back(static_cast<unsigned>(vertices.size() * nElements));
+
+            }
+
+            std::vector<T_Data> recvBlocks;
+            comm->reduceScatterVar(context, op, packed, recvBlocks, recvCount);
+
+            // Blocks arrive in the order in which this peer announced its vertices
+            const std::vector<Vertex> vertices = getHostedVertices(context.getVAddr());
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                T_Recv &dest = *recvDatas.at(vertices[i].id);
+                std::copy(recvBlocks.begin() + i * nElements, recvBlocks.begin() + (i + 1) * nElements, dest.begin());
+            }
+
+            reduce.clear();
+            recvDatas.clear();
+        }
+
+    }
+
     template<typename T_CommunicationPolicy, typename T_GraphPolicy>
     template<typename T_Send, typename T_Recv>
     auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
@@ -794,10 +1124,19 @@ namespace graybat {
         typedef typename T_Send::value_type SendValueType;
         typedef typename T_Recv::value_type RecvValueType;
 
-        static std::vector<SendValueType> gather;
-        static T_Recv *rootRecvData = NULL;
-        static bool peerHostsRootVertex = false;
-        static unsigned nGatherCalls = 0;
+        struct State {
+            std::vector<SendValueType> gather;
+            T_Recv *rootRecvData = nullptr;
+            bool peerHostsRootVertex = false;
+            unsigned nGatherCalls = 0;
+        };
+
+        std::lock_guard<std::mutex> lock(*collectiveMutex);
+        State &state = collectiveState<State>();
+        std::vector<SendValueType> &gather = state.gather;
+        T_Recv *&rootRecvData = state.rootRecvData;
+        bool &peerHostsRootVertex = state.peerHostsRootVertex;
+        unsigned &nGatherCalls = state.nGatherCalls;
 
         nGatherCalls++;
 
@@ -836,6 +1175,8 @@ namespace graybat {
 
             gather.clear();
             nGatherCalls = 0;
+            peerHostsRootVertex = false;
+            rootRecvData = nullptr;
 
         }
 
@@ -849,9 +1190,17 @@ namespace graybat {
         typedef typename T_Send::value_type SendValueType;
         typedef typename T_Recv::value_type RecvValueType;
 
-        static std::vector<SendValueType> gather;
-        static std::vector<T_Recv *> recvDatas;
-        static unsigned nGatherCalls = 0;
+        struct State {
+            std::vector<SendValueType> gather;
+            std::vector<T_Recv *> recvDatas;
+            unsigned nGatherCalls = 0;
+        };
+
+        std::lock_guard<std::mutex> lock(*collectiveMutex);
+        State &state = collectiveState<State>();
+        std::vector<SendValueType> &gather = state.gather;
+        std::vector<T_Recv *> &recvDatas = state.recvDatas;
+        unsigned &nGatherCalls = state.nGatherCalls;
         nGatherCalls++;
 
         VAddr srcVAddr = locateVertex(srcVertex);
@@ -883,8 +1232,23 @@ namespace graybat {
             }
 
             gather.clear();
+            recvDatas.clear();
+            nGatherCalls = 0;
+
+        }
 
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T_State>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    collectiveState()
+    -> T_State & {
+        std::shared_ptr<void> &state = collectiveStates[std::type_index(typeid(T_State))];
+        if (!state) {
+            state = std::make_shared<T_State>();
         }
+        return *static_cast<T_State *>(state.get());
 
     }
 
@@ -900,6 +1264,17 @@ namespace graybat {
         }
     }
 
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    spread(const Vertex &vertex, const T &data, EventSet &events)
+    -> void {
+        std::vector<Edge> edges = getOutEdges(vertex);
+        for (Edge edge: edges) {
+            Cage::send(edge, data, events);
+        }
+    }
+
     template<typename T_CommunicationPolicy, typename T_GraphPolicy>
     template<typename T>
     auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
@@ -933,11 +1308,309 @@ namespace graybat {
         comm->synchronize(graphContext);
     }
 
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    arrive()
+    -> Barrier {
+        return comm->asyncSynchronize(graphContext);
+    }
+
+
+    //!
+    //! Persistent Communication Operations
+    //!
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T, typename T_Channels>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    sendInit(const Edge &edge, const T &data, T_Channels &channels)
+    -> void {
+        VAddr destVAddr = locateVertex(edge.target);
+        comm->sendInit(destVAddr, edge.id, graphContext, data, channels);
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T, typename T_Channels>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    recvInit(const Edge &edge, T &data, T_Channels &channels)
+    -> void {
+        VAddr srcVAddr = locateVertex(edge.source);
+        comm->recvInit(srcVAddr, edge.id, graphContext, data, channels);
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T, typename T_Channels>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    spreadInit(const Vertex &vertex, const T &data, T_Channels &channels)
+    -> void {
+        std::vector<Edge> edges = getOutEdges(vertex);
+        for (Edge edge: edges) {
+            Cage::sendInit(edge, data, channels);
+        }
+    }
+
+
+    //!
+    //! Neighborhood Communication Operations
+    //!
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    createNeighborhood()
+    -> Neighborhood {
+        // Edges are ordered the same way by sender and receiver
+        using Slot = std::tuple<EdgeID, VertexID, VertexID, unsigned>;
+
+        if (!graphContext.valid()) {
+            return Neighborhood();
+        }
+
+        std::map<VAddr, std::vector<Slot> > outSlots;
+        std::map<VAddr, std::vector<Slot> > inSlots;
+        unsigned nInEdges = 0;
+
+        for (unsigned vertex_i = 0; vertex_i < hostedVertices.size(); ++vertex_i) {
+            for (Edge edge : getOutEdges(hostedVertices[vertex_i])) {
+                outSlots[locateVertex(edge.target)].push_back(Slot(edge.id, edge.source.id, edge.target.id, vertex_i));
+            }
+            for (Edge edge : getInEdges(hostedVertices[vertex_i])) {
+                inSlots[locateVertex(edge.source)].push_back(Slot(edge.id, edge.source.id, edge.target.id, nInEdges++));
+            }
+        }
+
+        std::vector<VAddr> destinations;
+        std::vector<std::vector<unsigned> > sendBlocks;
+        for (auto &peer : outSlots) {
+            std::sort(peer.second.begin(), peer.second.end());
+            destinations.push_back(peer.first);
+            sendBlocks.push_back(std::vector<unsigned>());
+            for (Slot const &slot : peer.second) {
+                sendBlocks.back().push_back(std::get<3>(slot));
+            }
+        }
+
+        std::vector<VAddr> sources;
+        std::vector<std::vector<unsigned> > recvBlocks;
+        for (auto &peer : inSlots) {
+            std::sort(peer.second.begin(), peer.second.end());
+            sources.push_back(peer.first);
+            recvBlocks.push_back(std::vector<unsigned>());
+            for (Slot const &slot : peer.second) {
+                recvBlocks.back().push_back(std::get<3>(slot));
+            }
+        }
+
+        return Neighborhood(comm->createNeighborhood(graphContext, sources, destinations),
+                            std::move(sendBlocks),
+                            std::move(recvBlocks),
+                            hostedVertices.size(),
+                            nInEdges);
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T_Send, typename T_Recv>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    exchange(Neighborhood &neighborhood, const T_Send &sendData, T_Recv &recvData)
+    -> void {
+        neighborhood.wait();
+        if (!graphContext.valid()) {
+            return;
+        }
+        pack(neighborhood, sendData, recvData);
+        comm->neighborAllToAll(neighborhood.neighborhood,
+                               neighborhood.sendBuffer, neighborhood.sendCounts,
+                               neighborhood.recvBuffer, neighborhood.recvCounts);
+        unpack(neighborhood, recvData);
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T_Send, typename T_Recv>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    asyncExchange(Neighborhood &neighborhood, const T_Send &sendData, T_Recv &recvData)
+    -> void {
+        neighborhood.wait();
+        if (!graphContext.valid()) {
+            return;
+        }
+        pack(neighborhood, sendData, recvData);
+        comm->asyncNeighborAllToAll(neighborhood.neighborhood,
+                                    neighborhood.sendBuffer, neighborhood.sendCounts,
+                                    neighborhood.recvBuffer, neighborhood.recvCounts);
+        // The neighborhood is passed in by wait(), thus it may be moved meanwhile
+        neighborhood.unpack = [this, &recvData](Neighborhood &self) {
+            unpack(self, recvData);
+        };
+    }
+
+    //!
+    //! One-Sided Communication Operations
+    //!
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T_Value>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    createWindow(std::size_t nElements)
+    -> Window {
+        using EdgeKey = typename Window::EdgeKey;
+
+        if (!graphContext.valid()) {
+            return Window();
+        }
+
+        const size_t slotSize = nElements * sizeof(T_Value);
+        const VAddr self = graphContext.getVAddr();
+        std::map<EdgeKey, size_t> remoteOffsets;
+        std::map<EdgeKey, size_t> localOffsets;
+        std::set<VAddr> origins;
+        std::set<VAddr> targets;
+        size_t nBytes = 0;
+
+        // Every peer lays out the slots of its incoming edges the same way
+        for (auto const &vAddr : graphContext) {
+            size_t offset = 0;
+            for (Vertex &v : getHostedVertices(vAddr)) {
+                for (Edge edge : getInEdges(v)) {
+                    const EdgeKey key(edge.id, edge.source.id, edge.target.id);
+                    const VAddr srcVAddr = locateVertex(edge.source);
+                    if (vAddr == self) {
+                        localOffsets[key] = offset;
+                        origins.insert(srcVAddr);
+                    }
+                    if (srcVAddr == self) {
+                        remoteOffsets[key] = offset;
+                        targets.insert(vAddr);
+                    }
+                    offset += slotSize;
+                }
+            }
+            if (vAddr == self) {
+                nBytes = offset;
+            }
+        }
+
+        return Window(comm->createWindow(graphContext,
+                                         nBytes,
+                                         std::vector<VAddr>(origins.begin(), origins.end()),
+                                         std::vector<VAddr>(targets.begin(), targets.end())),
+                      slotSize,
+                      std::move(remoteOffsets),
+                      std::move(localOffsets));
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    send(const Edge &edge, const T &data, Window &window)
+    -> void {
+        auto it = window.remoteOffsets.find(typename Window::EdgeKey(edge.id, edge.source.id, edge.target.id));
+        if (it == window.remoteOffsets.end()) {
+            std::stringstream errorMsg;
+            errorMsg << "[" << graphContext.getVAddr() << "] Edge " << edge.id << " has no slot in the window.";
+            throw std::runtime_error(errorMsg.str());
+        }
+        assert(data.size() * sizeof(typename T::value_type) <= window.slotSize);
+        comm->put(window.window, locateVertex(edge.target), graphContext, it->second, data);
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    recv(const Edge &edge, T &data, Window &window)
+    -> void {
+        auto it = window.localOffsets.find(typename Window::EdgeKey(edge.id, edge.source.id, edge.target.id));
+        if (it == window.localOffsets.end()) {
+            std::stringstream errorMsg;
+            errorMsg << "[" << graphContext.getVAddr() << "] Edge " << edge.id << " has no slot in the window.";
+            throw std::runtime_error(errorMsg.str());
+        }
+        const size_t nBytes = data.size() * sizeof(typename T::value_type);
+        assert(nBytes <= window.slotSize);
+        std::memcpy(data.data(), window.window.data() + it->second, nBytes);
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    fence(Window &window)
+    -> void {
+        if (window.window.valid()) {
+            comm->fence(window.window);
+        }
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    openEpoch(Window &window)
+    -> void {
+        if (window.window.valid()) {
+            comm->openEpoch(window.window);
+        }
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    closeEpoch(Window &window)
+    -> void {
+        if (window.window.valid()) {
+            comm->closeEpoch(window.window);
+        }
+    }
 
     //!
     //! Utilities
     //!
 
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T_Send, typename T_Recv>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    pack(Neighborhood &neighborhood, const T_Send &sendData, const T_Recv &recvData)
+    -> void {
+        const size_t sendBlockSize = neighborhood.nSendBlocks == 0 ? 0 :
+            sendData.size() * sizeof(typename T_Send::value_type) / neighborhood.nSendBlocks;
+        const size_t recvBlockSize = neighborhood.nRecvBlocks == 0 ? 0 :
+            recvData.size() * sizeof(typename T_Recv::value_type) / neighborhood.nRecvBlocks;
+        const std::int8_t *src = reinterpret_cast<const std::int8_t *>(sendData.data());
+
+        size_t nSendBytes = 0;
+        for (std::vector<unsigned> const &blocks : neighborhood.sendBlocks) {
+            nSendBytes += blocks.size() * sendBlockSize;
+        }
+        neighborhood.sendBuffer.resize(nSendBytes);
+        neighborhood.recvBuffer.resize(neighborhood.nRecvBlocks * recvBlockSize);
+
+        size_t offset = 0;
+        for (unsigned dest_i = 0; dest_i < neighborhood.sendBlocks.size(); ++dest_i) {
+            for (unsigned vertex_i : neighborhood.sendBlocks[dest_i]) {
+                std::memcpy(neighborhood.sendBuffer.data() + offset, src + vertex_i * sendBlockSize, sendBlockSize);
+                offset += sendBlockSize;
+            }
+            neighborhood.sendCounts[dest_i] = neighborhood.sendBlocks[dest_i].size() * sendBlockSize;
+        }
+
+        for (unsigned src_i = 0; src_i < neighborhood.recvBlocks.size(); ++src_i) {
+            neighborhood.recvCounts[src_i] = neighborhood.recvBlocks[src_i].size() * recvBlockSize;
+        }
+
+    }
+
+    template<typename T_CommunicationPolicy, typename T_GraphPolicy>
+    template<typename T_Recv>
+    auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
+    unpack(Neighborhood &neighborhood, T_Recv &recvData)
+    -> void {
+        const size_t recvBlockSize = neighborhood.nRecvBlocks == 0 ? 0 :
+            neighborhood.recvBuffer.size() / neighborhood.nRecvBlocks;
+        std::int8_t *dest = reinterpret_cast<std::int8_t *>(recvData.data());
+
+        size_t offset = 0;
+        for (std::vector<unsigned> const &blocks : neighborhood.recvBlocks) {
+            for (unsigned slot_i : blocks) {
+                std::memcpy(dest + slot_i * recvBlockSize, neighborhood.recvBuffer.data() + offset, recvBlockSize);
+                offset += recvBlockSize;
+            }
+        }
+
+    }
+
     template<typename T_CommunicationPolicy, typename T_GraphPolicy>
     template<class T>
     auto Cage<T_CommunicationPolicy, T_GraphPolicy>::
@@ -947,19 +1620,22 @@ namespace graybat {
 
         utils::exclusivePrefixSum(recvCount.begin(), recvCount.end(), prefixsum.begin());
 
+        // The blocks are ordered by the position of their peer in the context
+        size_t rank = 0;
         for (auto const &vAddr : graphContext) {
             const std::vector<Vertex> hostedVertices = getHostedVertices(vAddr);
-            const unsigned nElementsPerVertex = recvCount.at(vAddr) / static_cast<unsigned>(hostedVertices.size());
+            const unsigned nElementsPerVertex = recvCount.at(rank) / static_cast<unsigned>(hostedVertices.size());
 
             for (unsigned hostVertex_i = 0; hostVertex_i < hostedVertices.size(); hostVertex_i++) {
 
-                unsigned sourceOffset = prefixsum[vAddr] + (hostVertex_i * nElementsPerVertex);
+                unsigned sourceOffset = prefixsum[rank] + (hostVertex_i * nElementsPerVertex);
                 unsigned targetOffset = hostedVertices[hostVertex_i].id * nElementsPerVertex;
 
                 std::copy(data.begin() + sourceOffset,
                           data.begin() + sourceOffset + nElementsPerVertex,
                           dataReordered.begin() + targetOffset);
             }
+            ++rank;
         }
 
     }
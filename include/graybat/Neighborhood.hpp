@@ -0,0 +1,109 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>    // std::int8_t
+#include <functional> // std::function
+#include <utility>    // std::move
+#include <vector>     // std::vector
+
+namespace graybat {
+
+    /**
+     * @brief Peer level communication graph of a cage, created by
+     *        Cage::createNeighborhood after the graph was distributed.
+     *        One exchange moves the data of all hosted vertices along
+     *        all their edges with a single neighborhood collective of
+     *        the communication policy.
+     *
+     */
+    template <class T_Cage>
+    struct CommunicationNeighborhood {
+
+        typedef T_Cage                                             Cage;
+        typedef typename Cage::CommunicationPolicy::Neighborhood   PolicyNeighborhood;
+
+        CommunicationNeighborhood() :
+            nSendBlocks(0),
+            nRecvBlocks(0){
+
+        }
+
+        CommunicationNeighborhood(PolicyNeighborhood &&neighborhood,
+                                  std::vector<std::vector<unsigned> > sendBlocks,
+                                  std::vector<std::vector<unsigned> > recvBlocks,
+                                  std::size_t const nSendBlocks,
+                                  std::size_t const nRecvBlocks) :
+            neighborhood(std::move(neighborhood)),
+            sendBlocks(std::move(sendBlocks)),
+            recvBlocks(std::move(recvBlocks)),
+            nSendBlocks(nSendBlocks),
+            nRecvBlocks(nRecvBlocks),
+            sendCounts(this->sendBlocks.size(), 0),
+            recvCounts(this->recvBlocks.size(), 0){
+
+        }
+
+        CommunicationNeighborhood(CommunicationNeighborhood &&) = default;
+        CommunicationNeighborhood& operator=(CommunicationNeighborhood &&) = default;
+
+        // The buffers have to outlive a running exchange
+        ~CommunicationNeighborhood(){
+            neighborhood.wait();
+        }
+
+        /**
+         * @brief Waits until an exchange started by Cage::asyncExchange
+         *        finished and copies the received blocks into place.
+         */
+        void wait(){
+            neighborhood.wait();
+            if(unpack){
+                std::function<void (CommunicationNeighborhood&)> pending;
+                pending.swap(unpack);
+                pending(*this);
+            }
+        }
+
+        bool ready(){
+            return neighborhood.ready();
+        }
+
+        PolicyNeighborhood neighborhood;
+
+        // Indices of the hosted vertices sent to each destination peer
+        std::vector<std::vector<unsigned> > sendBlocks;
+
+        // Indices of the in-edge slots received from each source peer
+        std::vector<std::vector<unsigned> > recvBlocks;
+
+        std::size_t nSendBlocks;
+        std::size_t nRecvBlocks;
+
+        std::vector<std::int8_t> sendBuffer;
+        std::vector<std::int8_t> recvBuffer;
+        std::vector<unsigned> sendCounts;
+        std::vector<unsigned> recvCounts;
+        std::function<void (CommunicationNeighborhood&)> unpack;
+
+    };
+
+} /* namespace graybat */
@@ -33,6 +33,7 @@ namespace graybat {
         typedef typename Cage::GraphPolicy           GraphPolicy;
         typedef typename Cage::Edge                  Edge;
         typedef typename Cage::Event                 Event;
+        typedef typename Cage::EventSet              EventSet;
         typedef typename GraphPolicy::VertexProperty VertexProperty;
 
         VertexID id;
@@ -86,6 +87,11 @@ namespace graybat {
             cage.spread(*this, data, events);
         }
 
+        template <class T_Data>
+        void spread(const T_Data& data, EventSet &events){
+            cage.spread(*this, data, events);
+        }
+
         template <class T_Data>
         void spread(const T_Data& data){
             cage.spread(*this, data);
@@ -0,0 +1,74 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <map>     // std::map
+#include <tuple>   // std::tuple
+#include <utility> // std::move
+
+namespace graybat {
+
+    /**
+     * @brief Message slots of the hosted vertices of a peer, exposed for
+     *        one-sided access and created by Cage::createWindow. Every
+     *        incoming edge of a hosted vertex owns one slot of fixed
+     *        size, sending along an edge writes straight into the slot
+     *        of its target.
+     *
+     */
+    template <class T_Cage>
+    struct CommunicationWindow {
+
+        typedef T_Cage                                       Cage;
+        typedef typename Cage::CommunicationPolicy::Window   PolicyWindow;
+        typedef std::tuple<unsigned, unsigned, unsigned>     EdgeKey;
+
+        CommunicationWindow() :
+            slotSize(0){
+
+        }
+
+        CommunicationWindow(PolicyWindow &&window,
+                            std::size_t const slotSize,
+                            std::map<EdgeKey, std::size_t> remoteOffsets,
+                            std::map<EdgeKey, std::size_t> localOffsets) :
+            window(std::move(window)),
+            slotSize(slotSize),
+            remoteOffsets(std::move(remoteOffsets)),
+            localOffsets(std::move(localOffsets)){
+
+        }
+
+        PolicyWindow window;
+
+        // Bytes of a slot
+        std::size_t slotSize;
+
+        // Offsets of the slots of outgoing edges in the windows of their targets
+        std::map<EdgeKey, std::size_t> remoteOffsets;
+
+        // Offsets of the slots of incoming edges in the own window
+        std::map<EdgeKey, std::size_t> localOffsets;
+
+    };
+
+} /* namespace graybat */
@@ -29,8 +29,11 @@
 #include <iostream>  /* std::cout */
 #include <map>       /* std::map */
 #include <exception> /* std::out_of_range */
+#include <stdexcept> /* std::runtime_error */
 #include <sstream>   /* std::stringstream */
 #include <algorithm> /* std::transform */
+#include <vector>    /* std::vector */
+#include <type_traits> /* std::integral_constant */
 
 // BOOST
 #include <boost/mpi/environment.hpp>
@@ -47,7 +50,13 @@ namespace mpi = boost::mpi;
 #include <graybat/utils/serialize_tuple.hpp>
 #include <graybat/communicationPolicy/bmpi/Context.hpp> /* Context */
 #include <graybat/communicationPolicy/bmpi/Event.hpp>   /* Event */
+#include <graybat/communicationPolicy/bmpi/EventSet.hpp> /* EventSet */
+#include <graybat/communicationPolicy/bmpi/Channels.hpp> /* Channels */
+#include <graybat/communicationPolicy/bmpi/Neighborhood.hpp> /* Neighborhood */
+#include <graybat/communicationPolicy/bmpi/Window.hpp>  /* Window */
+#include <graybat/communicationPolicy/bmpi/Barrier.hpp> /* Barrier */
 #include <graybat/communicationPolicy/bmpi/Config.hpp>   /* Config */
+#include <graybat/communicationPolicy/bmpi/Datatype.hpp> /* GRAYBAT_MPI_DATATYPE */
 #include <graybat/communicationPolicy/Base.hpp> 
 #include <graybat/communicationPolicy/Traits.hpp>
 
@@ -83,11 +92,21 @@ namespace graybat {
                 using type = graybat::communicationPolicy::bmpi::Event;
             };
 
+            template<>
+            struct EventSetType<BMPI> {
+                using type = graybat::communicationPolicy::bmpi::EventSet;
+            };
+
             template<>
             struct ConfigType<BMPI> {
                 using type = graybat::communicationPolicy::bmpi::Config;
             };
 
+            template<>
+            struct BarrierType<BMPI> {
+                using type = graybat::communicationPolicy::bmpi::Barrier;
+            };
+
         }
         
 	struct BMPI : Base<BMPI>{
@@ -99,12 +118,26 @@ namespace graybat {
             using VAddr     = typename graybat::communicationPolicy::VAddr<BMPI>;
             using Context   = typename graybat::communicationPolicy::Context<BMPI>;
             using Event     = typename graybat::communicationPolicy::Event<BMPI>;
+            using EventSet  = typename graybat::communicationPolicy::EventSet<BMPI>;
+            using Channels  = graybat::communicationPolicy::bmpi::Channels;
+            using Neighborhood = graybat::communicationPolicy::bmpi::Neighborhood;
+            using Window    = graybat::communicationPolicy::bmpi::Window;
+            using Barrier   = typename graybat::communicationPolicy::Barrier<BMPI>;
             using Config    = typename graybat::communicationPolicy::Config<BMPI>;                        
             using Uri       = int;
 
-	    BMPI(Config const) :contextCount(0),
+	    BMPI(Config const config) :contextCount(0),
 							uriMap(0),
-							initialContext(contextCount, mpi::communicator()){
+							initialContext(contextCount, mpi::communicator()),
+							env(config.threadLevel){
+
+			// MPI might have been initialized before with another level
+			if(mpi::environment::thread_level() < config.threadLevel){
+				std::stringstream errorStream;
+				errorStream << "BMPI: MPI provides thread level " << mpi::environment::thread_level()
+					    << " but " << config.threadLevel << " was requested.";
+				throw std::runtime_error(errorStream.str());
+			}
 
 			uriMap.push_back(std::vector<Uri>());
 		
@@ -190,18 +223,43 @@ namespace graybat {
 
 	    }
 
+	    /**
+	     * @brief Blocking receive of the next message from any peer of
+	     *        the *context*. The message is matched and received with
+	     *        MPI_Mprobe/MPI_Mrecv, thus no other receive can take it
+	     *        in between. A std::vector *recvData* is resized to the
+	     *        size of the message.
+	     *
+	     * @return Event that knows source and tag of the message
+	     */
             template <typename T_Recv>
 	    Event recv(const Context context, T_Recv& recvData){
-                //std::cerr << mpi::any_source << " " << mpi::any_tag << std::endl;
-                
-                //auto status = context.comm.recv(mpi::any_source, mpi::any_tag, recvData.data(), recvData.size());
-                auto status = context.comm.probe();
-                context.comm.recv(status.source(), status.tag(), recvData.data(), recvData.size());
-                return Event(status);
-                
+		MPI_Message message;
+		MPI_Status status;
+		MPI_Mprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, context.comm, &message, &status);
+		mrecv(message, status, recvData);
+		return Event(status);
 
-                //auto status = context.comm.recv(boost::mpi::any_source, boost::mpi::any_tag, recvData.data(), recvData.size());
-                //auto status = context.comm.recv(boost::mpi::any_source, boost::mpi::any_tag);
+	    }
+
+	    /**
+	     * @brief Non blocking version of recv(context, recvData) based on
+	     *        MPI_Improbe. Receives the next message from any peer of
+	     *        the *context* if one arrived already.
+	     *
+	     * @return Event of the received message or none
+	     */
+            template <typename T_Recv>
+	    boost::optional<Event> tryRecv(const Context context, T_Recv& recvData){
+		MPI_Message message;
+		MPI_Status status;
+		int flag = 0;
+		MPI_Improbe(MPI_ANY_SOURCE, MPI_ANY_TAG, context.comm, &flag, &message, &status);
+		if(!flag){
+		    return boost::none;
+		}
+		mrecv(message, status, recvData);
+		return Event(status);
 
 	    }
 
@@ -228,6 +286,199 @@ namespace graybat {
             return Event(request);
 	    }
 
+	    /** @} */
+
+	    /***********************************************************************//**
+             *
+	     * @name Persistent Communication Interface
+	     *
+	     * @{
+	     *
+	     ***************************************************************************/
+	    /**
+	     * @brief Creates a persistent send of *sendData* to peer with virtual
+	     *        address destVAddr (MPI_Send_init) and adds it to *channels*.
+	     *        Each start of the channels sends the current content of
+	     *        *sendData*, thus it has to stay valid and keep its size.
+	     */
+	    template <typename T_Send>
+	    void sendInit(const VAddr destVAddr, const Tag tag, const Context context, const T_Send& sendData, Channels& channels){
+		Uri destUri = getVAddrUri(context, destVAddr);
+		MPI_Request request = MPI_REQUEST_NULL;
+		MPI_Send_init(const_cast<typename T_Send::value_type*>(sendData.data()), sendData.size(),
+			      mpi::get_mpi_datatype<typename T_Send::value_type>(*(sendData.data())),
+			      destUri, tag, context.comm, &request);
+		channels.add(request);
+
+	    }
+
+	    /**
+	     * @brief Creates a persistent receive into *recvData* from peer with
+	     *        virtual address srcVAddr (MPI_Recv_init) and adds it to
+	     *        *channels*.
+	     */
+	    template <typename T_Recv>
+	    void recvInit(const VAddr srcVAddr, const Tag tag, const Context context, T_Recv& recvData, Channels& channels){
+		Uri srcUri = getVAddrUri(context, srcVAddr);
+		MPI_Request request = MPI_REQUEST_NULL;
+		MPI_Recv_init(recvData.data(), recvData.size(),
+			      mpi::get_mpi_datatype<typename T_Recv::value_type>(*(recvData.data())),
+			      srcUri, tag, context.comm, &request);
+		channels.add(request);
+
+	    }
+
+
+	    /** @} */
+
+	    /***********************************************************************//**
+             *
+	     * @name Neighborhood Communication Interface
+	     *
+	     * @{
+	     *
+	     ***************************************************************************/
+	    /**
+	     * @brief Creates a distributed graph communicator
+	     *        (MPI_Dist_graph_create_adjacent) on top of *context*,
+	     *        in which this peer receives from the peers *sources*
+	     *        and sends to the peers *destinations*. Both lists
+	     *        may contain the own virtual address. Has to be
+	     *        called by all peers of the *context*.
+	     */
+	    Neighborhood createNeighborhood(const Context context, const std::vector<VAddr>& sources, const std::vector<VAddr>& destinations){
+		std::vector<int> srcUris;
+		std::vector<int> destUris;
+		for(VAddr const vAddr : sources){
+		    srcUris.push_back(getVAddrUri(context, vAddr));
+		}
+		for(VAddr const vAddr : destinations){
+		    destUris.push_back(getVAddrUri(context, vAddr));
+		}
+
+		MPI_Comm graphComm = MPI_COMM_NULL;
+		MPI_Dist_graph_create_adjacent(context.comm,
+					       static_cast<int>(srcUris.size()), srcUris.data(), MPI_UNWEIGHTED,
+					       static_cast<int>(destUris.size()), destUris.data(), MPI_UNWEIGHTED,
+					       MPI_INFO_NULL, 0, &graphComm);
+
+		return Neighborhood(mpi::communicator(graphComm, mpi::comm_take_ownership), srcUris.size(), destUris.size());
+
+	    }
+
+	    /**
+	     * @brief Sends sendCounts[i] consecutive elements of *sendData*
+	     *        to the ith destination and receives recvCounts[i]
+	     *        consecutive elements of *recvData* from the ith source
+	     *        of the *neighborhood* (MPI_Neighbor_alltoallv).
+	     */
+	    template <typename T_Send, typename T_Recv>
+	    void neighborAllToAll(Neighborhood& neighborhood, const T_Send& sendData, const std::vector<unsigned>& sendCounts, T_Recv& recvData, const std::vector<unsigned>& recvCounts){
+		using Value = typename T_Send::value_type;
+		neighborhood.wait();
+		setNeighborCounts(neighborhood, sendCounts, recvCounts);
+		MPI_Neighbor_alltoallv(const_cast<Value*>(sendData.data()), neighborhood.sendCounts.data(), neighborhood.sendDispls.data(),
+				       mpi::get_mpi_datatype<Value>(),
+				       recvData.data(), neighborhood.recvCounts.data(), neighborhood.recvDispls.data(),
+				       mpi::get_mpi_datatype<typename T_Recv::value_type>(),
+				       neighborhood.comm);
+
+	    }
+
+	    /**
+	     * @brief Non-blocking version of neighborAllToAll
+	     *        (MPI_Ineighbor_alltoallv). The exchange is finished
+	     *        after neighborhood.wait(), until then *sendData* and
+	     *        *recvData* have to stay valid.
+	     */
+	    template <typename T_Send, typename T_Recv>
+	    void asyncNeighborAllToAll(Neighborhood& neighborhood, const T_Send& sendData, const std::vector<unsigned>& sendCounts, T_Recv& recvData, const std::vector<unsigned>& recvCounts){
+		using Value = typename T_Send::value_type;
+		neighborhood.wait();
+		setNeighborCounts(neighborhood, sendCounts, recvCounts);
+		MPI_Ineighbor_alltoallv(const_cast<Value*>(sendData.data()), neighborhood.sendCounts.data(), neighborhood.sendDispls.data(),
+					mpi::get_mpi_datatype<Value>(),
+					recvData.data(), neighborhood.recvCounts.data(), neighborhood.recvDispls.data(),
+					mpi::get_mpi_datatype<typename T_Recv::value_type>(),
+					neighborhood.comm, &neighborhood.request);
+
+	    }
+
+	    /** @} */
+
+	    /***********************************************************************//**
+             *
+	     * @name One-Sided Communication Interface
+	     *
+	     * @{
+	     *
+	     ***************************************************************************/
+	    /**
+	     * @brief Allocates *nBytes* of memory on this peer that the peers
+	     *        of the *context* can write into (MPI_Win_allocate). Has
+	     *        to be called by all peers of the *context*.
+	     *
+	     * @param[in] origins  Peers that put into the window of this peer
+	     * @param[in] targets  Peers into whose windows this peer puts
+	     */
+	    Window createWindow(const Context context, const std::size_t nBytes, const std::vector<VAddr>& origins, const std::vector<VAddr>& targets){
+		MPI_Win window = MPI_WIN_NULL;
+		void* base = nullptr;
+		MPI_Win_allocate(static_cast<MPI_Aint>(nBytes), 1, MPI_INFO_NULL, context.comm, &base, &window);
+
+		MPI_Group group = MPI_GROUP_NULL;
+		MPI_Win_get_group(window, &group);
+		MPI_Group originGroup = createGroup(context, group, origins);
+		MPI_Group targetGroup = createGroup(context, group, targets);
+		MPI_Group_free(&group);
+
+		return Window(window, originGroup, targetGroup, base, nBytes);
+
+	    }
+
+	    /**
+	     * @brief Writes *sendData* at byte *offset* into the window of the
+	     *        peer with virtual address *destVAddr* (MPI_Put). The data
+	     *        arrives when the current epoch is closed and *sendData*
+	     *        has to stay valid until then.
+	     */
+	    template <typename T_Send>
+	    void put(Window& window, const VAddr destVAddr, const Context context, const std::size_t offset, const T_Send& sendData){
+		using Value = typename T_Send::value_type;
+		Uri destUri = getVAddrUri(context, destVAddr);
+		MPI_Put(const_cast<Value*>(sendData.data()), static_cast<int>(sendData.size()), mpi::get_mpi_datatype<Value>(),
+			destUri, static_cast<MPI_Aint>(offset), static_cast<int>(sendData.size()), mpi::get_mpi_datatype<Value>(),
+			window.window);
+
+	    }
+
+	    /**
+	     * @brief Closes the current epoch of all peers of the window and
+	     *        opens the next one (MPI_Win_fence).
+	     */
+	    void fence(Window& window){
+		MPI_Win_fence(0, window.window);
+	    }
+
+	    /**
+	     * @brief Opens a PSCW epoch in which only the origins of the
+	     *        window put into this peer and this peer puts into its
+	     *        targets (MPI_Win_post, MPI_Win_start).
+	     */
+	    void openEpoch(Window& window){
+		MPI_Win_post(window.origins, 0, window.window);
+		MPI_Win_start(window.targets, 0, window.window);
+	    }
+
+	    /**
+	     * @brief Closes the PSCW epoch, afterwards all puts of the
+	     *        origins are visible in the window (MPI_Win_complete,
+	     *        MPI_Win_wait).
+	     */
+	    void closeEpoch(Window& window){
+		MPI_Win_complete(window.window);
+		MPI_Win_wait(window.window);
+	    }
 
 	    /** @} */
     
@@ -449,6 +700,41 @@ namespace graybat {
 	     
 	    }
 
+	    /**
+	     * @brief Performs a reduction with a binary operator *op* on all *sendData* elements from all peers
+	     *        whithin the *context*. Every peer receives the block of the result that belongs
+	     *        to its VAddr. Operators known to MPI (std::plus etc.) are reduced by
+	     *        MPI_Reduce_scatter_block, others by the ring of the Base policy.
+	     *
+	     * @param[in]  context   Set of peers that
+	     * @param[in]  op        Commutative binary operator that should be used for reduction
+	     * @param[in]  sendData  Data that every peer contributes to the reduction. It consists
+	     *                       of context.size() blocks of recvData.size() elements.
+	     * @param[out] recvData  Block of the reduced sendData with index of the peers VAddr.
+	     *
+	     */
+	    template <typename T_Send, typename T_Recv, typename T_Op>
+	    void reduceScatter(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData){
+		using ValueType = typename T_Recv::value_type;
+		reduceScatterImpl(context, op, sendData, recvData, std::integral_constant<bool, mpi::is_mpi_op<T_Op, ValueType>::value>());
+
+	    }
+
+	    /**
+	     * @brief Performs a reduceScatter with blocks of **varying** size by
+	     *        MPI_Reduce_scatter or the ring of the Base policy.
+	     *
+	     * @param[in]  recvCount Number of elements each peer receives. *recvData*
+	     *                       will be resized to recvCount.at(context.getVAddr()).
+	     *
+	     */
+	    template <typename T_Send, typename T_Recv, typename T_Op>
+	    void reduceScatterVar(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData, const std::vector<unsigned>& recvCount){
+		using ValueType = typename T_Recv::value_type;
+		reduceScatterVarImpl(context, op, sendData, recvData, recvCount, std::integral_constant<bool, mpi::is_mpi_op<T_Op, ValueType>::value>());
+
+	    }
+
 	
 	    /**
 	     * @brief Send *sendData* from peer *rootVAddr* to all peers in *context*.
@@ -478,6 +764,18 @@ namespace graybat {
 		 context.comm.barrier();
 	     }
 
+	    /**
+	     * @brief Arrives at a barrier of all peers within *context* without
+	     *        waiting for the others (MPI_Ibarrier). The returned barrier
+	     *        is ready once all peers arrived.
+	     *
+	     */
+	     Barrier asyncSynchronize(const Context context){
+		 Barrier barrier;
+		 MPI_Ibarrier(context.comm, &barrier.request);
+		 return barrier;
+	     }
+
 	
 	    /**
 	     * @brief Synchronizes all peers within the globalContext
@@ -511,7 +809,7 @@ namespace graybat {
                     std::array<Uri, 1> uri {{ (int) newContext.getVAddr() }};
                     uriMap.push_back(std::vector<Uri>(newContext.size()));
 
-                    std::vector<Event> events;
+                    EventSet events;
                     
                     for(auto const &vAddr : newContext){
                         events.push_back(Event(newContext.comm.isend(vAddr, 0, uri.data(), 1)));
@@ -524,10 +822,7 @@ namespace graybat {
                         
                     }
 
-                    for(unsigned i = 0; i < events.size(); ++i){
-                        events.back().wait();
-                        events.pop_back();
-                    }
+                    events.waitAll();
 
                     return newContext;
 
@@ -567,6 +862,39 @@ namespace graybat {
 	     * @name Helper Functions
 	     *
 	     ***************************************************************************/
+
+	    template <typename T_Send, typename T_Recv, typename T_Op>
+	    void reduceScatterImpl(const Context context, T_Op, const T_Send& sendData, T_Recv& recvData, std::true_type){
+		using ValueType = typename T_Recv::value_type;
+		MPI_Reduce_scatter_block(sendData.data(), recvData.data(), static_cast<int>(recvData.size()),
+					 mpi::get_mpi_datatype<ValueType>(), mpi::is_mpi_op<T_Op, ValueType>::op(),
+					 context.comm);
+
+	    }
+
+	    template <typename T_Send, typename T_Recv, typename T_Op>
+	    void reduceScatterImpl(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData, std::false_type){
+		Base<BMPI>::reduceScatter(context, op, sendData, recvData);
+
+	    }
+
+	    template <typename T_Send, typename T_Recv, typename T_Op>
+	    void reduceScatterVarImpl(const Context context, T_Op, const T_Send& sendData, T_Recv& recvData, const std::vector<unsigned>& recvCount, std::true_type){
+		using ValueType = typename T_Recv::value_type;
+		// The VAddr of a peer is its rank in the communicator of the context
+		std::vector<int> counts(recvCount.begin(), recvCount.end());
+		recvData.resize(recvCount.at(context.getVAddr()));
+		MPI_Reduce_scatter(sendData.data(), recvData.data(), counts.data(),
+				   mpi::get_mpi_datatype<ValueType>(), mpi::is_mpi_op<T_Op, ValueType>::op(),
+				   context.comm);
+
+	    }
+
+	    template <typename T_Send, typename T_Recv, typename T_Op>
+	    void reduceScatterVarImpl(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData, const std::vector<unsigned>& recvCount, std::false_type){
+		Base<BMPI>::reduceScatterVar(context, op, sendData, recvData, recvCount);
+
+	    }
 	    
 	    
 	    void error(VAddr vAddr, std::string msg){
@@ -574,6 +902,55 @@ namespace graybat {
 
 	    }
 
+	    /**
+	     * @brief Receives the matched *message* into *recvData*. A
+	     *        std::vector is sized to the probed element count first.
+	     */
+	    template <typename T_Recv>
+	    void mrecv(MPI_Message& message, MPI_Status& status, T_Recv& recvData){
+		using Value = typename T_Recv::value_type;
+		int count = 0;
+		MPI_Get_count(&status, mpi::get_mpi_datatype<Value>(), &count);
+		fitRecv(recvData, static_cast<std::size_t>(count));
+		MPI_Mrecv(recvData.data(), static_cast<int>(recvData.size()), mpi::get_mpi_datatype<Value>(), &message, MPI_STATUS_IGNORE);
+	    }
+
+	    template <typename T_Value, typename T_Allocator>
+	    static void fitRecv(std::vector<T_Value, T_Allocator>& recvData, std::size_t const count){
+		recvData.resize(count);
+	    }
+
+	    template <typename T_Recv>
+	    static void fitRecv(T_Recv&, std::size_t const){
+	    }
+
+	    MPI_Group createGroup(const Context context, MPI_Group group, const std::vector<VAddr>& vAddrs){
+		std::vector<int> uris;
+		for(VAddr const vAddr : vAddrs){
+		    uris.push_back(getVAddrUri(context, vAddr));
+		}
+		MPI_Group subGroup = MPI_GROUP_NULL;
+		MPI_Group_incl(group, static_cast<int>(uris.size()), uris.data(), &subGroup);
+		return subGroup;
+	    }
+
+	    void setNeighborCounts(Neighborhood& neighborhood, const std::vector<unsigned>& sendCounts, const std::vector<unsigned>& recvCounts){
+		assert(sendCounts.size() == neighborhood.nDestinations());
+		assert(recvCounts.size() == neighborhood.nSources());
+		int sendDispl = 0;
+		for(std::size_t i = 0; i < sendCounts.size(); ++i){
+		    neighborhood.sendCounts[i] = static_cast<int>(sendCounts[i]);
+		    neighborhood.sendDispls[i] = sendDispl;
+		    sendDispl += neighborhood.sendCounts[i];
+		}
+		int recvDispl = 0;
+		for(std::size_t i = 0; i < recvCounts.size(); ++i){
+		    neighborhood.recvCounts[i] = static_cast<int>(recvCounts[i]);
+		    neighborhood.recvDispls[i] = recvDispl;
+		    recvDispl += neighborhood.recvCounts[i];
+		}
+	    }
+
 	    /**
 	     * @brief Returns the uri of a vAddr in a
 	     *        specific context.
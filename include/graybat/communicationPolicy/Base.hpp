@@ -20,7 +20,17 @@
 
 #pragma once
 
+// STL
+#include <utility>   /* std::move */
+#include <array>     /* std::array */
+#include <vector>    /* std::vector */
+#include <numeric>   /* std::accumulate */
+#include <algorithm> /* std::copy, std::min */
+#include <cstddef>   /* std::size_t */
+
 #include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/DisseminationBarrier.hpp> /* DisseminationBarrier */
+#include <graybat/utils/Span.hpp>                 /* utils::Span */
 
 namespace graybat {
     
@@ -44,6 +54,8 @@ namespace graybat {
             using Tag                 = typename graybat::communicationPolicy::Tag<CommunicationPolicy>;
             using Context             = typename graybat::communicationPolicy::Context<CommunicationPolicy>;
             using Event               = typename graybat::communicationPolicy::Event<CommunicationPolicy>;
+            using EventSet            = typename graybat::communicationPolicy::EventSet<CommunicationPolicy>;
+            using Barrier             = typename graybat::communicationPolicy::Barrier<CommunicationPolicy>;
 
             // TODO
             // ====
@@ -65,6 +77,10 @@ namespace graybat {
              *
 	     * @name Point to Point Communication Interface
 	     *
+	     * Buffers only need to provide data(), size() and value_type,
+	     * thus a utils::Span sends or receives a slice of a larger
+	     * buffer in place.
+	     *
 	     * @{
 	     *
 	     ***************************************************************************/
@@ -118,7 +134,7 @@ namespace graybat {
 	     * @param[in]  sendData   Data that every peer in the *context* sends. The Data can have **varying** size
 	     * @param[out] recvData   Data from all *context* peers, that peer with *rootVAddr* will receive.
 	     *                        *recvData* of all other peers of the *context* will be empty. The received
-	     *                        data is ordered by the VAddr of the peers.
+	     *                        data is ordered by the position of the peers in the *context*.
 	     * @param[out] recvCount  Number of elements each peer sends (can by varying).
 	     *
 	     */
@@ -129,6 +145,10 @@ namespace graybat {
 	     * @brief Collects *sendData* from all members of the *context*  and transmits it as a list
 	     *        to every peer in the *context*
 	     *
+	     * The blocks are exchanged in ceil(log2(P)) rounds, in round k every
+	     * peer forwards the 2^k blocks it already holds (Bruck's variant of
+	     * recursive doubling, thus P needs not to be a power of two).
+	     *
 	     * @param[in]  context  Set of peers that want to send Data
 	     * @param[in]  sendData Data that every peer in the *context* sends with **same** size
 	     * @param[out] recvData Data from all *context* members, that all peers* will receive.
@@ -161,6 +181,10 @@ namespace graybat {
              * @param[in]  sendData   Data that peer with *rootVAddr* will distribute over the peers of the *context*
              * @param[out] recvData   Data from peer with *rootVAddr*.
              *
+             * The blocks are passed down a binomial tree rooted at *rootVAddr*,
+             * every peer forwards the blocks of its subtree. The root sends
+             * directly from slices of *sendData*.
+             *
              */
             template <typename T_Send, typename T_Recv>
             void scatter(const VAddr rootVAddr, const Context context, const T_Send& sendData, T_Recv& recvData);
@@ -195,6 +219,10 @@ namespace graybat {
 	     *                       It will have same size of sendData and contains the ith
 	     *                       reduced sendData values.
 	     *
+	     * The partial results are combined along a binomial tree rooted at
+	     * *rootVAddr* in ceil(log2(P)) rounds. Partial results are combined
+	     * in member order relative to the root, *op* needs to be associative.
+	     *
 	     */
 	    template <typename T_Send, typename T_Recv, typename T_Op>
 	    void reduce(const VAddr rootVAddr, const Context context, const T_Op op, const T_Send& sendData, T_Recv& recvData);
@@ -210,10 +238,60 @@ namespace graybat {
 	     *                       It will have same size of sendData and contains the ith
 	     *                       reduced sendData values.
 	     *
+	     * Peers exchange their partial results by recursive doubling in
+	     * log2(P) rounds. If P is no power of two, the surplus peers first
+	     * fold their data into a neighbor and receive the result at the end.
+	     * Vectors of at least ringThreshold bytes are reduced by a ring
+	     * reduceScatter followed by a ring allGather instead, every peer then
+	     * sends only 2 (P-1)/P of the vector. The ring reorders the operands,
+	     * thus it is only taken when traits::IsCommutative holds for *op*.
+	     *
 	     */
 	    template <typename T_Send, typename T_Recv, typename T_Op>
 	    void allReduce(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData);
 
+	    /**
+	     * @brief Performs a reduction with a binary operator *op* on all *sendData* elements from all peers
+	     *        whithin the *context* and distributes the result. Every peer receives the
+	     *        block of the result that belongs to its position in the *context*.
+	     *
+	     * @param[in]  context   Set of peers that
+	     * @param[in]  op        Commutative binary operator that should be used for reduction
+	     * @param[in]  sendData  Data that every peer contributes to the reduction. It consists
+	     *                       of context.size() blocks of recvData.size() elements.
+	     * @param[out] recvData  Block of the reduced sendData with the position of the peer in the *context*.
+	     *
+	     * The blocks travel P-1 steps around a ring and are reduced on the way.
+	     *
+	     */
+	    template <typename T_Send, typename T_Recv, typename T_Op>
+	    void reduceScatter(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData);
+
+	    /**
+	     * @brief Performs a reduceScatter with blocks of **varying** size.
+	     *
+	     * @param[in]  context   Set of peers that
+	     * @param[in]  op        Commutative binary operator that should be used for reduction
+	     * @param[in]  sendData  Data that every peer contributes to the reduction. It consists
+	     *                       of context.size() blocks of recvCount elements.
+	     * @param[out] recvData  Block of the reduced sendData with the position of the peer in the *context*.
+	     *                       It will be resized to recvCount.at(context.getVAddr()).
+	     * @param[in]  recvCount Number of elements each peer receives.
+	     *
+	     */
+	    template <typename T_Send, typename T_Recv, typename T_Op>
+	    void reduceScatterVar(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData, const std::vector<unsigned>& recvCount);
+
+	    /**
+	     * @brief Size in bytes from which on allReduce reduces by ring.
+	     */
+	    static constexpr std::size_t ringThreshold = 64 * 1024;
+
+	    /**
+	     * @brief Size in bytes of the segments a large broadcast is pipelined in.
+	     */
+	    static constexpr std::size_t segmentSize = 64 * 1024;
+
             /**
 	     * @brief Send *sendData* from peer *rootVAddr* to all peers in *context*.
 	     *        Every peer will receive the same data.
@@ -224,6 +302,11 @@ namespace graybat {
 	     * @param[in] context    Set of peers that want to receive Data
 	     * @param[in] sendData   Data that peer with *rootVAddr* will send to the peers of the *context*
 	     * @param[out] recvData  Data from peer with *rootVAddr*.
+	     *
+	     * The data is forwarded along a binomial tree rooted at *rootVAddr*
+	     * in ceil(log2(P)) rounds. Data larger than segmentSize is split into
+	     * segments that are pipelined along a chain of all peers instead, thus
+	     * every peer sends the data only once.
 	     */
             template <typename T_SendRecv>
             void broadcast(const VAddr rootVAddr, const Context context, T_SendRecv& data);
@@ -231,9 +314,19 @@ namespace graybat {
 	    /**
 	     * @brief Synchronizes all peers within *context* to the same point
 	     *        in the programm execution (barrier).
+	     *
+	     * Dissemination barrier of ceil(log2(P)) rounds.
 	     *        
 	     */
             void synchronize(const Context context);
+
+	    /**
+	     * @brief Arrives at a barrier of all peers within *context* without
+	     *        waiting for the others. The returned barrier is ready once
+	     *        all peers arrived.
+	     *
+	     */
+            Barrier asyncSynchronize(const Context context);
 	    /** @} */
 
 
@@ -257,7 +350,43 @@ namespace graybat {
 	    Context getGlobalContext() = delete;            
 
 	    /** @} */            
-            
+
+	private:
+            /**
+             * @brief Sends the blocks [sendFirst, sendFirst + nBlocks) of *data*
+             *        to *destVAddr* and receives the blocks [recvFirst, recvFirst + nBlocks)
+             *        from *srcVAddr* in place. Block indices wrap around
+             *        context.size(), *offset* maps a block index to its first element.
+             */
+            template <typename T_Data, typename T_Offset>
+            void exchangeBlocks(const Context context,
+                                const VAddr destVAddr, const std::size_t sendFirst,
+                                const VAddr srcVAddr, const std::size_t recvFirst,
+                                const std::size_t nBlocks, T_Data& data, T_Offset offset);
+
+            /**
+             * @brief Exchanges the blocks of an allGather, the block of the
+             *        calling peer has to be in place already.
+             */
+            template <typename T_Data, typename T_Offset>
+            void allGatherBlocks(const Context context, T_Data& data, T_Offset offset);
+
+            /**
+             * @brief Reduces the blocks of *sendData* around the ring of all
+             *        peers, *offset* maps a block index to its first element.
+             *        Returns with the reduced block of the calling peer in *reduced*,
+             *        *tmpData* is used as receive buffer.
+             */
+            template <typename T_Send, typename T_Block, typename T_Offset, typename T_Op>
+            void ringReduceScatter(const Context context, T_Op op, const T_Send& sendData, T_Block& reduced, T_Block& tmpData, T_Offset offset);
+
+            /**
+             * @brief Calls f(begin, end) for the element ranges of the blocks
+             *        [first, first + nBlocks). The block range wraps around
+             *        *nPeers*, thus it consists of one or two ranges.
+             */
+            template <typename T_Offset, typename T_Functor>
+            static void forEachSlice(const std::size_t nPeers, const std::size_t first, const std::size_t nBlocks, T_Offset offset, T_Functor f);
             
         };
 
@@ -267,54 +396,62 @@ namespace graybat {
         template <typename T_CommunicationPolicy>
         template <typename T_Send, typename T_Recv>
         void Base<T_CommunicationPolicy>::gather(const VAddr rootVAddr, const Context context, const T_Send& sendData, T_Recv& recvData){
-            using RecvValueType       = typename T_Recv::value_type;
             using CommunicationPolicy = T_CommunicationPolicy;
-            using Event               = Base<CommunicationPolicy>::Event;
 
-            Event e = static_cast<CommunicationPolicy*>(this)->asyncSend(rootVAddr, 0, context, sendData);
-                
             if(rootVAddr == context.getVAddr()){
+                // Received blocks go straight into their slice of recvData,
+                // which is ordered by the position of the peers in the context
+                size_t recvOffset = 0;
                 for(auto const &vAddr : context){
-                    size_t recvOffset = vAddr * sendData.size(); 
-                    std::vector<RecvValueType> tmpData(sendData.size());
-                    static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
-                    std::copy(tmpData.begin(), tmpData.end(), recvData.begin() + recvOffset);
+                    if(vAddr == rootVAddr){
+                        std::copy(sendData.begin(), sendData.end(), recvData.begin() + recvOffset);
+                    }
+                    else {
+                        auto slice = ::utils::makeSpan(recvData, recvOffset, sendData.size());
+                        static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, slice);
+                    }
+                    recvOffset += sendData.size();
                         
                 }
                     
             }
+            else {
+                static_cast<CommunicationPolicy*>(this)->send(rootVAddr, 0, context, sendData);
 
-            e.wait();
+            }
                 
         }
 
         template <typename T_CommunicationPolicy>        
         template <typename T_Send, typename T_Recv>
         void Base<T_CommunicationPolicy>::gatherVar(const VAddr rootVAddr, const Context context, const T_Send& sendData, T_Recv& recvData, std::vector<unsigned>& recvCount){
-            using RecvValueType       = typename T_Recv::value_type;
             using CommunicationPolicy = T_CommunicationPolicy;
-            using Event               = Base<CommunicationPolicy>::Event;
 
             std::array<unsigned, 1> nElements{{(unsigned)sendData.size()}};
             recvCount.resize(context.size());
             static_cast<CommunicationPolicy*>(this)->allGather(context, nElements, recvCount);
             recvData.resize(std::accumulate(recvCount.begin(), recvCount.end(), 0U));            
             
-            Event e = static_cast<CommunicationPolicy*>(this)->asyncSend(rootVAddr, 0, context, sendData);
-            
             if(rootVAddr == context.getVAddr()){
                 size_t recvOffset = 0;
-                for(auto const &vAddr : context){                    
-                    std::vector<RecvValueType> tmpData(recvCount.at(vAddr));
-                    static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
-                    std::copy(tmpData.begin(), tmpData.end(), recvData.begin() + recvOffset);
-                    recvOffset += recvCount.at(vAddr);
+                std::size_t rank  = 0;
+                for(auto const &vAddr : context){
+                    if(vAddr == rootVAddr){
+                        std::copy(sendData.begin(), sendData.end(), recvData.begin() + recvOffset);
+                    }
+                    else {
+                        auto slice = ::utils::makeSpan(recvData, recvOffset, recvCount.at(rank));
+                        static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, slice);
+                    }
+                    recvOffset += recvCount.at(rank++);
                         
                 }
 
             }
+            else {
+                static_cast<CommunicationPolicy*>(this)->send(rootVAddr, 0, context, sendData);
 
-            e.wait();
+            }
 
         }
         
@@ -323,125 +460,148 @@ namespace graybat {
         template <typename T_CommunicationPolicy>
         template <typename T_Send, typename T_Recv>
         void Base<T_CommunicationPolicy>::allGather(Context context, const T_Send& sendData, T_Recv& recvData){
-            using RecvValueType       = typename T_Recv::value_type;
-            using CommunicationPolicy = T_CommunicationPolicy;
-            using Event               = Base<CommunicationPolicy>::Event;
-
-            std::vector<Event> events;
-            
-            for(auto const &vAddr : context){                
-                events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, sendData));
+            const std::size_t nElements = sendData.size();
 
-            }
-
-            for(auto const &vAddr : context){                
-                size_t recvOffset = vAddr * sendData.size(); 
-                std::vector<RecvValueType> tmpData(sendData.size());
-                static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
-                std::copy(tmpData.begin(), tmpData.end(), recvData.begin() + recvOffset);
-                        
-            }
-
-            for(unsigned i = 0; i < events.size(); ++i){
-                events.back().wait();
-                events.pop_back();
-            }        
+            std::copy(sendData.begin(), sendData.end(), recvData.begin() + context.rankOf(context.getVAddr()) * nElements);
+            allGatherBlocks(context, recvData, [nElements](std::size_t const block){ return block * nElements; });
             
         }
 
         template <typename T_CommunicationPolicy>        
         template <typename T_Send, typename T_Recv>
         void Base<T_CommunicationPolicy>::allGatherVar(const Context context, const T_Send& sendData, T_Recv& recvData, std::vector<unsigned>& recvCount){
-            using RecvValueType       = typename T_Recv::value_type;
             using CommunicationPolicy = T_CommunicationPolicy;
-            using Event               = Base<CommunicationPolicy>::Event;
 
-            std::vector<Event> events;
-            
             std::array<unsigned, 1> nElements{{(unsigned)sendData.size()}};
             recvCount.resize(context.size());
             static_cast<CommunicationPolicy*>(this)->allGather(context, nElements, recvCount);
             recvData.resize(std::accumulate(recvCount.begin(), recvCount.end(), 0U));            
 
-            for(auto const &vAddr : context){                
-                events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, sendData));
-            }
-            
-            size_t recvOffset = 0;
-            for(auto const &vAddr : context){                
-                std::vector<RecvValueType> tmpData(recvCount.at(vAddr));
-                static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
-                std::copy(tmpData.begin(), tmpData.end(), recvData.begin() + recvOffset);
-                recvOffset += recvCount.at(vAddr);
-                        
-            }
+            // Element offset of each block
+            std::vector<std::size_t> recvDispls(context.size() + 1, 0);
+            std::partial_sum(recvCount.begin(), recvCount.end(), recvDispls.begin() + 1);
 
-            for(unsigned i = 0; i < events.size(); ++i){
-                events.back().wait();
-                events.pop_back();
-            }
+            std::copy(sendData.begin(), sendData.end(), recvData.begin() + recvDispls.at(context.rankOf(context.getVAddr())));
+            allGatherBlocks(context, recvData, [&recvDispls](std::size_t const block){ return recvDispls[block]; });
             
         }
         
         template <typename T_CommunicationPolicy>
         template <typename T_Send, typename T_Recv>
         void Base<T_CommunicationPolicy>::scatter(const VAddr rootVAddr, const Context context, const T_Send& sendData, T_Recv& recvData){
-            using SendValueType       = typename T_Recv::value_type;
+            using RecvValueType       = typename T_Recv::value_type;
             using CommunicationPolicy = T_CommunicationPolicy;
-            using Event               = Base<CommunicationPolicy>::Event;            
-
-            std::vector<Event> events;
-            
-            if(rootVAddr == context.getVAddr()){
-                for(auto const &vAddr : context){                    
-                    size_t sendOffset = vAddr * recvData.size(); 
-                    std::vector<SendValueType> tmpData(sendData.begin() + sendOffset,
-                                                       sendData.begin() + sendOffset + recvData.size());
-                    events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, tmpData));
-                        
+            using EventSet            = Base<CommunicationPolicy>::EventSet;            
+
+            const std::size_t nPeers    = context.size();
+            const std::size_t nElements = recvData.size();
+            const std::size_t rootRank  = context.rankOf(rootVAddr);
+            // Position in the context relative to the root of the tree
+            const std::size_t rank      = (context.rankOf(context.getVAddr()) + nPeers - rootRank) % nPeers;
+            // Blocks are indexed by the position of their peer in the context
+            auto blockOf = [nPeers, rootRank](std::size_t const relRank){ return (relRank + rootRank) % nPeers; };
+            auto vAddrOf = [&context, &blockOf](std::size_t const relRank){ return context.vAddrOf(blockOf(relRank)); };
+            auto offset  = [nElements](std::size_t const block){ return block * nElements; };
+
+            // Blocks of the subtree below this peer without its own block,
+            // in relative rank order. The root reads them from sendData.
+            std::vector<RecvValueType> subtreeData;
+
+            // Receive the own block and the blocks of the subtree from the parent
+            std::size_t mask = 1;
+            while(mask < nPeers){
+                if(rank & mask){
+                    const std::size_t parent   = rank - mask;
+                    const std::size_t nSubtree = std::min(mask, nPeers - rank);
+                    static_cast<CommunicationPolicy*>(this)->recv(vAddrOf(parent), 0, context, recvData);
+
+                    subtreeData.resize((nSubtree - 1) * nElements);
+                    if(nSubtree > 1 && parent == 0){
+                        // The root sends a subtree that wraps around the member positions in two slices
+                        std::size_t recvOffset = 0;
+                        forEachSlice(nPeers, blockOf(rank + 1), nSubtree - 1, offset, [&](std::size_t const begin, std::size_t const end){
+                                auto slice = ::utils::makeSpan(subtreeData, recvOffset, end - begin);
+                                static_cast<CommunicationPolicy*>(this)->recv(vAddrOf(parent), 0, context, slice);
+                                recvOffset += end - begin;
+                            });
+                    }
+                    else if(nSubtree > 1){
+                        static_cast<CommunicationPolicy*>(this)->recv(vAddrOf(parent), 0, context, subtreeData);
+                    }
+                    break;
                 }
-                    
+                mask <<= 1;
+            }
+
+            if(rank == 0){
+                std::copy(sendData.begin() + offset(rootRank), sendData.begin() + offset(rootRank + 1), recvData.begin());
             }
 
-            static_cast<CommunicationPolicy*>(this)->recv(rootVAddr, 0, context, recvData);
+            // Forward the blocks of each child subtree, largest subtree first
+            EventSet events;
+            for(mask >>= 1; mask > 0; mask >>= 1){
+                const std::size_t child = rank + mask;
+                if(child >= nPeers){
+                    continue;
+                }
+                const std::size_t nSubtree = std::min(mask, nPeers - child);
+
+                if(rank == 0){
+                    events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(vAddrOf(child), 0, context, ::utils::makeSpan(sendData, offset(blockOf(child)), nElements)));
+                    if(nSubtree > 1){
+                        forEachSlice(nPeers, blockOf(child + 1), nSubtree - 1, offset, [&](std::size_t const begin, std::size_t const end){
+                                events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(vAddrOf(child), 0, context, ::utils::makeSpan(sendData, begin, end - begin)));
+                            });
+                    }
+                }
+                else {
+                    // Block of relative rank r is at r - rank - 1 in subtreeData
+                    events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(vAddrOf(child), 0, context, ::utils::makeSpan(subtreeData, offset(mask - 1), nElements)));
+                    if(nSubtree > 1){
+                        events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(vAddrOf(child), 0, context, ::utils::makeSpan(subtreeData, offset(mask), (nSubtree - 1) * nElements)));
+                    }
+                }
 
-            for(unsigned i = 0; i < events.size(); ++i){
-                events.back().wait();
-                events.pop_back();
             }
 
+            events.waitAll();
+
         }
 
         template <typename T_CommunicationPolicy>        
         template <typename T_Send, typename T_Recv>
         void Base<T_CommunicationPolicy>::allScatter(const Context context, const T_Send& sendData, T_Recv& recvData){
-            using SendValueType       = typename T_Recv::value_type;
             using CommunicationPolicy = T_CommunicationPolicy;
-            using Event               = Base<CommunicationPolicy>::Event;            
+            using EventSet            = Base<CommunicationPolicy>::EventSet;            
 
-            std::vector<Event> events;
+            EventSet events;
             size_t nElementsPerPeer = static_cast<size_t>(recvData.size() / context.size());
+            const std::size_t self  = context.rankOf(context.getVAddr());
             
-            for(auto const &vAddr : context){                
-                size_t sendOffset = vAddr * nElementsPerPeer; 
-                std::vector<SendValueType> tmpData(sendData.begin() + sendOffset,
-                                                   sendData.begin() + sendOffset + nElementsPerPeer);
-                events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, tmpData));
+            // Blocks are send from and received into slices of the
+            // callers buffers, the own block is copied locally
+            for(std::size_t rank = 0; rank < context.size(); ++rank){
+                if(rank == self){
+                    continue;
+                }
+                events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(context.vAddrOf(rank), 0, context, ::utils::makeSpan(sendData, rank * nElementsPerPeer, nElementsPerPeer)));
                 
             }
 
-            for(auto const &vAddr : context){                
-                size_t recvOffset = vAddr * nElementsPerPeer;
-                std::vector<SendValueType> tmpData(nElementsPerPeer);
-                static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
-                std::copy(tmpData.begin(), tmpData.end(), recvData.begin() + recvOffset);
+            std::copy(sendData.begin() + self * nElementsPerPeer,
+                      sendData.begin() + (self + 1) * nElementsPerPeer,
+                      recvData.begin() + self * nElementsPerPeer);
+
+            for(std::size_t rank = 0; rank < context.size(); ++rank){
+                if(rank == self){
+                    continue;
+                }
+                auto slice = ::utils::makeSpan(recvData, rank * nElementsPerPeer, nElementsPerPeer);
+                static_cast<CommunicationPolicy*>(this)->recv(context.vAddrOf(rank), 0, context, slice);
                 
             }
 
-            for(unsigned i = 0; i < events.size(); ++i){
-                events.back().wait();
-                events.pop_back();
-            }
+            events.waitAll();
             
         }
 
@@ -451,24 +611,38 @@ namespace graybat {
         void Base<T_CommunicationPolicy>::reduce(const VAddr rootVAddr, const Context context, const T_Op op, const T_Send& sendData, T_Recv& recvData){
             using RecvValueType       = typename T_Recv::value_type;
             using CommunicationPolicy = T_CommunicationPolicy;
-            using Event               = Base<CommunicationPolicy>::Event;
 
-            Event e = static_cast<CommunicationPolicy*>(this)->asyncSend(rootVAddr, 0, context, sendData);
-            
-            if(rootVAddr == context.getVAddr()){
-                for(auto const &vAddr : context){
-                    std::vector<RecvValueType> tmpData(recvData.size());
-                    static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
+            const std::size_t nPeers   = context.size();
+            const std::size_t rootRank = context.rankOf(rootVAddr);
+            // Position in the context relative to the root of the tree
+            const std::size_t rank     = (context.rankOf(context.getVAddr()) + nPeers - rootRank) % nPeers;
 
-                    for(size_t i = 0; i < recvData.size(); ++i){
-                        recvData[i] = op(recvData[i], tmpData[i]);
+            std::vector<RecvValueType> reduced(sendData.begin(), sendData.end());
+            std::vector<RecvValueType> tmpData(reduced.size());
+
+            // Combine the results of the subtrees, then pass them to the parent
+            for(std::size_t mask = 1; mask < nPeers; mask <<= 1){
+                if(rank & mask){
+                    const VAddr parent = context.vAddrOf((rank - mask + rootRank) % nPeers);
+                    static_cast<CommunicationPolicy*>(this)->send(parent, 0, context, reduced);
+                    break;
+                }
+
+                if(rank + mask < nPeers){
+                    const VAddr child = context.vAddrOf((rank + mask + rootRank) % nPeers);
+                    static_cast<CommunicationPolicy*>(this)->recv(child, 0, context, tmpData);
+
+                    for(size_t i = 0; i < reduced.size(); ++i){
+                        reduced[i] = op(reduced[i], tmpData[i]);
                     }
-                    
+
                 }
-                
+
             }
 
-            e.wait();
+            if(rank == 0){
+                std::copy(reduced.begin(), reduced.end(), recvData.begin());
+            }
 
         }
 
@@ -480,77 +654,289 @@ namespace graybat {
             using CommunicationPolicy = T_CommunicationPolicy;
             using Event               = Base<CommunicationPolicy>::Event;
 
-            std::vector<Event> events;            
-            for(auto const &vAddr : context){                
-                Event e = static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, sendData);
+            const std::size_t nPeers = context.size();
+            const std::size_t rank   = context.rankOf(context.getVAddr());
+            const std::size_t nElements = recvData.size();
+
+            if(traits::IsCommutative<T_Op>::value && nPeers > 1 && nElements >= nPeers && nElements * sizeof(RecvValueType) >= ringThreshold){
+                // Balanced blocks, the first nElements % nPeers blocks are one element larger
+                auto offset = [nElements, nPeers](std::size_t const block){
+                    return block * (nElements / nPeers) + std::min(block, nElements % nPeers);
+                };
+
+                std::vector<RecvValueType> reduced;
+                std::vector<RecvValueType> tmpData;
+                ringReduceScatter(context, op, sendData, reduced, tmpData, offset);
+                std::copy(reduced.begin(), reduced.end(), recvData.begin() + offset(rank));
+
+                // Pass the reduced blocks around the ring
+                const VAddr right = context.vAddrOf((rank + 1) % nPeers);
+                const VAddr left  = context.vAddrOf((rank + nPeers - 1) % nPeers);
+                for(std::size_t step = 0; step < nPeers - 1; ++step){
+                    exchangeBlocks(context, right, (rank + nPeers - step) % nPeers, left, (rank + nPeers - step - 1) % nPeers, 1, recvData, offset);
+                }
+                return;
+
             }
-            
-            for(auto const &vAddr : context){                
-                std::vector<RecvValueType> tmpData(recvData.size());
-                static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
 
-                for(size_t i = 0; i < recvData.size(); ++i){
-                    recvData[i] = op(recvData[i], tmpData[i]);
+            // Largest power of two not greater than nPeers
+            std::size_t pof2 = 1;
+            while(pof2 * 2 <= nPeers){
+                pof2 *= 2;
+            }
+            const std::size_t nSurplus = nPeers - pof2;
+
+            std::copy(sendData.begin(), sendData.end(), recvData.begin());
+            std::vector<RecvValueType> tmpData(recvData.size());
+
+            // The first 2 * nSurplus peers pair up, the even ones
+            // hand their data to the odd ones and wait for the result.
+            bool participates = true;
+            std::size_t newRank = rank - nSurplus;
+            if(rank < 2 * nSurplus){
+                if(rank % 2 == 0){
+                    static_cast<CommunicationPolicy*>(this)->send(context.vAddrOf(rank + 1), 0, context, recvData);
+                    participates = false;
                 }
-                    
+                else {
+                    static_cast<CommunicationPolicy*>(this)->recv(context.vAddrOf(rank - 1), 0, context, tmpData);
+                    for(size_t i = 0; i < recvData.size(); ++i){
+                        recvData[i] = op(tmpData[i], recvData[i]);
+                    }
+                    newRank = rank / 2;
+                }
+
+            }
+
+            // Recursive doubling between pof2 peers
+            if(participates){
+                for(std::size_t mask = 1; mask < pof2; mask <<= 1){
+                    const std::size_t newPartner = newRank ^ mask;
+                    const VAddr partner = context.vAddrOf(newPartner < nSurplus ? newPartner * 2 + 1 : newPartner + nSurplus);
+
+                    Event e = static_cast<CommunicationPolicy*>(this)->asyncSend(partner, 0, context, recvData);
+                    static_cast<CommunicationPolicy*>(this)->recv(partner, 0, context, tmpData);
+                    e.wait();
+
+                    // Keep the VAddr order of the operands
+                    for(size_t i = 0; i < recvData.size(); ++i){
+                        recvData[i] = newPartner < newRank ? op(tmpData[i], recvData[i]) : op(recvData[i], tmpData[i]);
+                    }
+
+                }
+
             }
 
-            for(unsigned i = 0; i < events.size(); ++i){
-                events.back().wait();
-                events.pop_back();
+            if(rank < 2 * nSurplus){
+                if(participates){
+                    static_cast<CommunicationPolicy*>(this)->send(context.vAddrOf(rank - 1), 0, context, recvData);
+                }
+                else {
+                    static_cast<CommunicationPolicy*>(this)->recv(context.vAddrOf(rank + 1), 0, context, recvData);
+                }
+
             }
             
         }
 
         
+        template <typename T_CommunicationPolicy>
+        template <typename T_Send, typename T_Recv, typename T_Op>
+        void Base<T_CommunicationPolicy>::reduceScatter(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData){
+            using RecvValueType = typename T_Recv::value_type;
+
+            const std::size_t nElements = recvData.size();
+
+            std::vector<RecvValueType> reduced;
+            std::vector<RecvValueType> tmpData;
+            ringReduceScatter(context, op, sendData, reduced, tmpData, [nElements](std::size_t const block){ return block * nElements; });
+            std::copy(reduced.begin(), reduced.end(), recvData.begin());
+
+        }
+
+        template <typename T_CommunicationPolicy>
+        template <typename T_Send, typename T_Recv, typename T_Op>
+        void Base<T_CommunicationPolicy>::reduceScatterVar(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData, const std::vector<unsigned>& recvCount){
+            using RecvValueType = typename T_Recv::value_type;
+
+            // Element offset of each block
+            std::vector<std::size_t> sendDispls(context.size() + 1, 0);
+            std::partial_sum(recvCount.begin(), recvCount.end(), sendDispls.begin() + 1);
+
+            std::vector<RecvValueType> reduced;
+            std::vector<RecvValueType> tmpData;
+            ringReduceScatter(context, op, sendData, reduced, tmpData, [&sendDispls](std::size_t const block){ return sendDispls[block]; });
+            recvData.resize(reduced.size());
+            std::copy(reduced.begin(), reduced.end(), recvData.begin());
+
+        }
+
         template <typename T_CommunicationPolicy>
         template <typename T_SendRecv>
         void Base<T_CommunicationPolicy>::broadcast(const VAddr rootVAddr, const Context context, T_SendRecv& data){
             using CommunicationPolicy = T_CommunicationPolicy;
 
-            std::vector<Event> events;
-            
-            if(rootVAddr == context.getVAddr()){
-                for(auto const &vAddr : context){                
-                    static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, data);
-                        
+            using ValueType           = typename T_SendRecv::value_type;
+
+            const std::size_t nPeers   = context.size();
+            const std::size_t rootRank = context.rankOf(rootVAddr);
+            // Position in the context relative to the root of the tree
+            const std::size_t rank     = (context.rankOf(context.getVAddr()) + nPeers - rootRank) % nPeers;
+
+            if(data.size() * sizeof(ValueType) > segmentSize){
+                const std::size_t nSegmentElements = std::max<std::size_t>(1, segmentSize / sizeof(ValueType));
+                const std::size_t self = context.rankOf(context.getVAddr());
+                const VAddr prev = context.vAddrOf((self + nPeers - 1) % nPeers);
+                const VAddr next = context.vAddrOf((self + 1) % nPeers);
+
+                // Forward a segment as soon as it arrived, while the
+                // next segment is on its way
+                EventSet events;
+                for(std::size_t begin = 0; begin < data.size(); begin += nSegmentElements){
+                    auto segment = ::utils::makeSpan(data, begin, std::min(nSegmentElements, data.size() - begin));
+                    if(rank > 0){
+                        static_cast<CommunicationPolicy*>(this)->recv(prev, 0, context, segment);
+                    }
+                    if(rank + 1 < nPeers){
+                        events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(next, 0, context, segment));
+                    }
+
                 }
-                    
+
+                events.waitAll();
+                return;
+
             }
 
-            static_cast<CommunicationPolicy*>(this)->recv(rootVAddr, 0, context, data);
+            // Receive from the parent, the root has none
+            std::size_t mask = 1;
+            while(mask < nPeers){
+                if(rank & mask){
+                    const VAddr parent = context.vAddrOf((rank - mask + rootRank) % nPeers);
+                    static_cast<CommunicationPolicy*>(this)->recv(parent, 0, context, data);
+                    break;
+                }
+                mask <<= 1;
+            }
+
+            // Forward to the children, largest subtree first
+            EventSet events;
+            for(mask >>= 1; mask > 0; mask >>= 1){
+                if(rank + mask < nPeers){
+                    const VAddr child = context.vAddrOf((rank + mask + rootRank) % nPeers);
+                    events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(child, 0, context, data));
+                }
 
-            for(unsigned i = 0; i < events.size(); ++i){
-                events.back().wait();
-                events.pop_back();
             }
+
+            events.waitAll();
             
         }
 
         
-        template <typename T_CommunicationPolicy>        
-        void Base<T_CommunicationPolicy>::synchronize(const Context context){
-            std::array<char, 0> null;
-            
-            if(context.getVAddr() == 0){
-                for(auto const &vAddr : context){                    
-                    static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, null);
-                    
-                }
-                
-                for(auto const &vAddr : context){                    
-                    static_cast<CommunicationPolicy*>(this)->send(vAddr, 0, context, null);
-                    
-                }
-                    
+        template <typename T_CommunicationPolicy>
+        template <typename T_Data, typename T_Offset>
+        void Base<T_CommunicationPolicy>::exchangeBlocks(const Context context,
+                                                         const VAddr destVAddr, const std::size_t sendFirst,
+                                                         const VAddr srcVAddr, const std::size_t recvFirst,
+                                                         const std::size_t nBlocks, T_Data& data, T_Offset offset){
+            using CommunicationPolicy = T_CommunicationPolicy;
+
+            const std::size_t nPeers = context.size();
+
+            EventSet events;
+            forEachSlice(nPeers, sendFirst, nBlocks, offset, [&](std::size_t const begin, std::size_t const end){
+                    events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(destVAddr, 0, context, ::utils::makeSpan(data, begin, end - begin)));
+                });
+
+            forEachSlice(nPeers, recvFirst, nBlocks, offset, [&](std::size_t const begin, std::size_t const end){
+                    auto slice = ::utils::makeSpan(data, begin, end - begin);
+                    static_cast<CommunicationPolicy*>(this)->recv(srcVAddr, 0, context, slice);
+                });
+
+            events.waitAll();
+
+        }
+
+        template <typename T_CommunicationPolicy>
+        template <typename T_Offset, typename T_Functor>
+        void Base<T_CommunicationPolicy>::forEachSlice(const std::size_t nPeers, const std::size_t first, const std::size_t nBlocks, T_Offset offset, T_Functor f){
+            if(first + nBlocks <= nPeers){
+                f(offset(first), offset(first + nBlocks));
             }
             else {
-                static_cast<CommunicationPolicy*>(this)->send(0, 0, context, null);                
-                static_cast<CommunicationPolicy*>(this)->recv(0, 0, context, null);
+                f(offset(first), offset(nPeers));
+                f(offset(0), offset(first + nBlocks - nPeers));
+            }
+
+        }
+
+        template <typename T_CommunicationPolicy>
+        template <typename T_Data, typename T_Offset>
+        void Base<T_CommunicationPolicy>::allGatherBlocks(const Context context, T_Data& data, T_Offset offset){
+            const std::size_t nPeers = context.size();
+            const std::size_t rank   = context.rankOf(context.getVAddr());
+
+            // Every peer holds the blocks [rank, rank + nHeld) and doubles them
+            // each round with the blocks of the peer nHeld ahead.
+            for(std::size_t nHeld = 1; nHeld < nPeers;){
+                const std::size_t nBlocks = std::min(nHeld, nPeers - nHeld);
+                const std::size_t dest    = (rank + nPeers - nHeld) % nPeers;
+                const std::size_t src     = (rank + nHeld) % nPeers;
+
+                exchangeBlocks(context, context.vAddrOf(dest), rank, context.vAddrOf(src), src, nBlocks, data, offset);
+                nHeld += nBlocks;
+            }
+
+        }
+
+        template <typename T_CommunicationPolicy>
+        template <typename T_Send, typename T_Block, typename T_Offset, typename T_Op>
+        void Base<T_CommunicationPolicy>::ringReduceScatter(const Context context, T_Op op, const T_Send& sendData, T_Block& reduced, T_Block& tmpData, T_Offset offset){
+            using CommunicationPolicy = T_CommunicationPolicy;
+            using Event               = Base<CommunicationPolicy>::Event;
+
+            const std::size_t nPeers = context.size();
+            const std::size_t rank   = context.rankOf(context.getVAddr());
+            const VAddr right = context.vAddrOf((rank + 1) % nPeers);
+            const VAddr left  = context.vAddrOf((rank + nPeers - 1) % nPeers);
+
+            // Start with the own contribution to the block of the left neighbor
+            std::size_t block = (rank + nPeers - 1) % nPeers;
+            reduced.assign(sendData.begin() + offset(block), sendData.begin() + offset(block + 1));
+
+            // Each step the partial block moves one peer to the right and the
+            // peer adds its contribution, after P-1 steps it reaches its owner.
+            for(std::size_t step = 0; step < nPeers - 1; ++step){
+                block = (rank + 2 * nPeers - step - 2) % nPeers;
+                tmpData.resize(offset(block + 1) - offset(block));
+
+                Event e = static_cast<CommunicationPolicy*>(this)->asyncSend(right, 0, context, reduced);
+                static_cast<CommunicationPolicy*>(this)->recv(left, 0, context, tmpData);
+                e.wait();
+
+                reduced.swap(tmpData);
+                for(std::size_t i = 0; i < reduced.size(); ++i){
+                    reduced[i] = op(reduced[i], sendData[offset(block) + i]);
+                }
+
             }
 
         }
 
+        template <typename T_CommunicationPolicy>        
+        void Base<T_CommunicationPolicy>::synchronize(const Context context){
+            asyncSynchronize(context).wait();
+
+        }
+
+        template <typename T_CommunicationPolicy>
+        auto Base<T_CommunicationPolicy>::asyncSynchronize(const Context context)
+            -> Barrier {
+            return Barrier(*static_cast<CommunicationPolicy*>(this), context);
+
+        }
+
     } // namespace communicationPolicy
     
 } // namespace graybat
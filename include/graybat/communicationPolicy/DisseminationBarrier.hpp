@@ -0,0 +1,172 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <array>     /* std::array */
+#include <cstddef>   /* std::size_t */
+#include <limits>    /* std::numeric_limits */
+#include <utility>   /* std::move, std::swap */
+#include <vector>    /* std::vector */
+
+#include <graybat/communicationPolicy/Traits.hpp>
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        /**
+         * @brief Split-phase barrier built from point to point messages.
+         *
+         * In round k every peer signals the peer 2^k ahead and waits
+         * for the signal of the peer 2^k behind, after ceil(log2(P))
+         * rounds every peer knows that all peers arrived. The rounds
+         * progress in ready() and wait(), thus a peer can keep working
+         * between arriving and waiting.
+         *
+         * A barrier has to be finished before the next one on the same
+         * context is started, a dropped barrier is finished by its
+         * destructor.
+         *
+         */
+        template <typename T_CommunicationPolicy>
+        class DisseminationBarrier {
+            using CommunicationPolicy = T_CommunicationPolicy;
+            using Context             = graybat::communicationPolicy::Context<CommunicationPolicy>;
+            using Event               = graybat::communicationPolicy::Event<CommunicationPolicy>;
+            using VAddr               = graybat::communicationPolicy::VAddr<CommunicationPolicy>;
+            using Tag                 = graybat::communicationPolicy::Tag<CommunicationPolicy>;
+
+        public:
+            // Barrier signals do not match messages of the user
+            static constexpr Tag tag = std::numeric_limits<Tag>::max();
+
+            /**
+             * @brief Arrives at the barrier of *context*.
+             */
+            DisseminationBarrier(CommunicationPolicy &comm, Context const context) :
+                comm(&comm),
+                context(context),
+                distance(1){
+                post();
+
+            }
+
+            DisseminationBarrier(DisseminationBarrier &&other) :
+                comm(other.comm),
+                context(other.context),
+                distance(other.distance),
+                sends(std::move(other.sends)),
+                signals(std::move(other.signals)){
+                other.sends.clear();
+                other.signals.clear();
+            }
+
+            DisseminationBarrier& operator=(DisseminationBarrier &&other){
+                std::swap(comm, other.comm);
+                std::swap(context, other.context);
+                std::swap(distance, other.distance);
+                std::swap(sends, other.sends);
+                std::swap(signals, other.signals);
+                return *this;
+            }
+
+            DisseminationBarrier(DisseminationBarrier &) = delete;
+            DisseminationBarrier& operator=(DisseminationBarrier &) = delete;
+
+            /**
+             * @brief Finishes the barrier, thus its signals can not
+             *        be taken by the next barrier on the context.
+             */
+            ~DisseminationBarrier(){
+                wait();
+            }
+
+            /**
+             * @brief Returns true when all peers arrived, advances
+             *        the rounds whose signal already arrived.
+             */
+            bool ready(){
+                while(!signals.empty()){
+                    if(!signals.back().ready()){
+                        return false;
+                    }
+                    signals.clear();
+                    distance <<= 1;
+                    post();
+                }
+
+                for(Event &e : sends){
+                    if(!e.ready()){
+                        return false;
+                    }
+                }
+                return true;
+
+            }
+
+            /**
+             * @brief Blocks until all peers arrived.
+             */
+            void wait(){
+                while(!signals.empty()){
+                    signals.back().wait();
+                    signals.clear();
+                    distance <<= 1;
+                    post();
+                }
+
+                for(Event &e : sends){
+                    e.wait();
+                }
+
+            }
+
+        private:
+            CommunicationPolicy *comm;
+            Context context;
+            std::size_t distance;
+            std::vector<Event> sends;
+            // Pending signal of the current round
+            std::vector<Event> signals;
+
+            static std::array<char, 0>& null(){
+                static std::array<char, 0> null;
+                return null;
+            }
+
+            void post(){
+                const std::size_t nPeers = context.size();
+                if(distance >= nPeers){
+                    return;
+                }
+
+                const std::size_t rank = context.rankOf(context.getVAddr());
+                sends.push_back(comm->asyncSend(context.vAddrOf((rank + distance) % nPeers), tag, context, null()));
+                signals.push_back(comm->asyncRecv(context.vAddrOf((rank + nPeers - distance) % nPeers), tag, context, null()));
+
+            }
+
+        };
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
@@ -0,0 +1,275 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// CLIB
+#include <unistd.h>   /* getpid */
+
+// STL
+#include <algorithm>  /* std::min */
+#include <sstream>    /* std::stringstream */
+#include <string>     /* std::string */
+#include <vector>     /* std::vector */
+
+// ZMQ
+#include <zmq.hpp>    /* zmq::socket_t, zmq::context_t */
+
+// BOOST
+#include <boost/interprocess/exceptions.hpp>
+
+// GrayBat
+#include <graybat/communicationPolicy/socket/Base.hpp> /* Base */
+#include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/zmq/Context.hpp> /* Context */
+#include <graybat/communicationPolicy/zmq/Event.hpp>   /* Event */
+#include <graybat/communicationPolicy/zmq/EventSet.hpp> /* EventSet */
+#include <graybat/communicationPolicy/shm/Message.hpp> /* Message */
+#include <graybat/communicationPolicy/shm/Config.hpp>  /* Config */
+#include <graybat/communicationPolicy/shm/Ring.hpp>    /* Ring */
+
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+	/************************************************************************//**
+	 * @class SHM
+	 *
+	 * @brief Implementation of the Cage communicationPolicy interface
+	 *        based on POSIX shared memory.
+	 *
+	 * Every peer creates a shared memory ring for data messages and
+	 * one for flow control credits. Peers write directly into the rings of
+	 * their destinations, thus a message is copied once into and
+	 * once out of shared memory. Peers have to run on the same host.
+	 * The zmq signaling server is still used to exchange ring names.
+	 *
+	 ***************************************************************************/
+        struct SHM;
+
+        namespace traits {
+
+            template<>
+            struct ContextType<SHM> {
+                using type = graybat::communicationPolicy::zmq::Context<SHM>;
+            };
+
+            template<>
+            struct ContextIDType<SHM> {
+                using type = unsigned;
+            };
+
+            template<>
+            struct EventType<SHM> {
+                using type = graybat::communicationPolicy::zmq::Event<SHM>;
+            };
+
+            template<>
+            struct EventSetType<SHM> {
+                using type = graybat::communicationPolicy::zmq::EventSet<SHM>;
+            };
+
+            template<>
+            struct ConfigType<SHM> {
+                using type = graybat::communicationPolicy::shm::Config;
+            };
+
+
+        }
+
+        namespace socket {
+
+            namespace traits {
+
+                template<>
+                struct UriType<SHM> {
+                    using type = std::string;
+                };
+
+                template<>
+                struct SocketType<SHM> {
+                    using type = graybat::communicationPolicy::shm::Ring;
+                };
+
+                template<>
+                struct MessageType<SHM> {
+                    using type = graybat::communicationPolicy::shm::Message<SHM>;
+                };
+
+            }
+
+        }
+
+	struct SHM : public graybat::communicationPolicy::socket::Base<SHM> {
+
+	    // Type defs
+            using Tag        = graybat::communicationPolicy::Tag<SHM>;
+            using ContextID  = graybat::communicationPolicy::ContextID<SHM>;
+            using MsgID      = graybat::communicationPolicy::MsgID<SHM>;
+            using VAddr      = graybat::communicationPolicy::VAddr<SHM>;
+            using Context    = graybat::communicationPolicy::Context<SHM>;
+            using Event      = graybat::communicationPolicy::Event<SHM>;
+            using EventSet   = graybat::communicationPolicy::EventSet<SHM>;
+            using Config     = graybat::communicationPolicy::Config<SHM>;
+            using MsgType    = graybat::communicationPolicy::MsgType<SHM>;
+            using Uri        = graybat::communicationPolicy::socket::Uri<SHM>;
+            using Socket     = graybat::communicationPolicy::socket::Socket<SHM>;
+            using Message    = graybat::communicationPolicy::socket::Message<SHM>;
+            using SocketBase = graybat::communicationPolicy::socket::Base<SHM>;
+
+            // Signaling
+            ::zmq::context_t zmqContext;
+            ::zmq::socket_t signalingSocket;
+
+	    // Shared memory rings
+            const size_t ringSize;
+            Socket recvSocket;
+            Socket ctrlSocket;
+            std::vector<Socket> sendSockets;
+            std::vector<Socket> ctrlSendSockets;
+
+            // Uri
+	    const Uri peerUri;
+            const Uri ctrlUri;
+
+
+            // Construct
+	    SHM(Config const config) :
+                SocketBase(config),
+		zmqContext(1),
+		signalingSocket(zmqContext, ZMQ_REQ),
+                ringSize(config.ringSize),
+                peerUri(bindToNextFreeName(recvSocket, config.contextName)),
+                ctrlUri(bindToNextFreeName(ctrlSocket, config.contextName))
+            {
+
+                SocketBase::init();
+
+            }
+
+        // Copy constructor
+        SHM(SHM &)  = delete;
+        // Copy assignment constructor
+        SHM& operator=(SHM &) = delete;
+        // Move constructor
+	    SHM(SHM &&other) = delete;
+        // Move assignment constructor
+        SHM& operator=(SHM &&) = delete;
+
+        // Destructor
+        ~SHM(){
+            SocketBase::deinit();
+        }
+
+	    /***********************************************************************//**
+             *
+	     * @name Socket base utilities
+	     *
+	     * @{
+	     *
+	     ***************************************************************************/
+
+        void createSocketsToPeers(){
+            for(auto const &vAddr : initialContext){
+                (void)vAddr;
+                sendSockets.emplace_back(Socket());
+                ctrlSendSockets.emplace_back(Socket());
+            }
+        }
+
+            void connectToSocket(::zmq::socket_t& socket, std::string const signalingUri) {
+                socket.connect(signalingUri.c_str());
+
+            }
+
+            void connectToSocket(Socket& socket, std::string const name) {
+                socket.open(name);
+
+            }
+
+	    void recvFromSocket(::zmq::socket_t& socket, std::stringstream& ss) {
+		::zmq::message_t message;
+		socket.recv(&message);
+                ss << static_cast<char*>(message.data());
+	    }
+
+	    void recvFromSocket(Socket& socket, Message & message) {
+                socket.read(message.getMessage());
+	    }
+
+	    void recvHeaderFromSocket(Socket& socket, Message & message) {
+                size_t const size = socket.readSize();
+                message.getMessage().resize(Message::headerSize);
+                socket.readInto(message.getMessage().data(), Message::headerSize);
+                message.pendingSize = size - Message::headerSize;
+	    }
+
+	    void recvPayloadFromSocket(Socket& socket, Message & message) {
+                message.getMessage().resize(Message::headerSize + message.pendingSize);
+                socket.readInto(message.getData(), message.pendingSize);
+                message.pendingSize = 0;
+	    }
+
+	    void recvPayloadFromSocket(Socket& socket, Message & message, std::int8_t * data, size_t const size) {
+                size_t const n = std::min(size, message.pendingSize);
+                socket.readInto(data, n);
+                socket.skip(message.pendingSize - n);
+                message.pendingSize = 0;
+	    }
+
+	    void sendToSocket(::zmq::socket_t& socket, std::stringstream const & ss) {
+                std::string string = ss.str();
+		::zmq::message_t message(sizeof(char) * string.size());
+		memcpy (static_cast<char*>(message.data()), string.data(), sizeof(char) * string.size());
+		socket.send(message);
+	    }
+
+	    void sendToSocket(Socket& socket, Message & message) {
+                socket.write(message.getMessage().data(), message.getMessage().size(), message.payload, message.payloadSize);
+            }
+
+	    Uri bindToNextFreeName(Socket &socket, const std::string contextName){
+                std::string baseName = "graybat_" + contextName + "_" + std::to_string(getpid()) + "_";
+                unsigned n           = 0;
+		bool created         = false;
+
+		std::string name;
+		while(!created){
+                    try {
+                        name = baseName + std::to_string(n);
+                        socket.create(name, ringSize);
+                        created = true;
+                    }
+                    catch(boost::interprocess::interprocess_exception const &){
+                        n++;
+                    }
+
+                }
+
+		return name;
+
+            }
+
+	}; // class SHM
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
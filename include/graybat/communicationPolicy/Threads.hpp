@@ -0,0 +1,331 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <array>      /* std::array */
+#include <atomic>     /* std::atomic */
+#include <cstdint>    /* std::int8_t */
+#include <memory>     /* std::shared_ptr */
+#include <string>     /* std::string */
+#include <utility>    /* std::move */
+#include <vector>     /* std::vector */
+
+// GrayBat
+#include <graybat/communicationPolicy/Base.hpp>               /* Base */
+#include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/zmq/Context.hpp>        /* Context */
+#include <graybat/communicationPolicy/threads/Event.hpp>      /* Event */
+#include <graybat/communicationPolicy/threads/EventSet.hpp>   /* EventSet */
+#include <graybat/communicationPolicy/threads/Config.hpp>     /* Config */
+#include <graybat/communicationPolicy/threads/Mailbox.hpp>    /* Mailbox */
+#include <graybat/communicationPolicy/threads/Hub.hpp>        /* Hub */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+	/************************************************************************//**
+	 * @class Threads
+	 *
+	 * @brief Implementation of the Cage communicationPolicy interface
+	 *        where every peer is a thread of the same process.
+	 *
+	 * Each thread constructs its own policy (or Cage) object. Objects
+	 * with the same context name form the initial context, thus no
+	 * signaling server is needed. A message that meets a posted receive
+	 * is copied once, directly into its buffer. Any other message is
+	 * copied into a queued buffer first and from there into the buffer
+	 * of the receive that takes it.
+	 *
+	 ***************************************************************************/
+        struct Threads;
+
+        namespace traits {
+
+            template<>
+            struct ContextType<Threads> {
+                using type = graybat::communicationPolicy::zmq::Context<Threads>;
+            };
+
+            template<>
+            struct ContextIDType<Threads> {
+                using type = unsigned;
+            };
+
+            template<>
+            struct EventType<Threads> {
+                using type = graybat::communicationPolicy::threads::Event<Threads>;
+            };
+
+            template<>
+            struct EventSetType<Threads> {
+                using type = graybat::communicationPolicy::threads::EventSet<Threads>;
+            };
+
+            template<>
+            struct ConfigType<Threads> {
+                using type = graybat::communicationPolicy::threads::Config;
+            };
+
+        }
+
+	struct Threads : Base<Threads> {
+
+	    // Type defs
+            using Tag       = graybat::communicationPolicy::Tag<Threads>;
+            using ContextID = graybat::communicationPolicy::ContextID<Threads>;
+            using MsgType   = graybat::communicationPolicy::MsgType<Threads>;
+            using MsgID     = graybat::communicationPolicy::MsgID<Threads>;
+            using VAddr     = graybat::communicationPolicy::VAddr<Threads>;
+            using Context   = graybat::communicationPolicy::Context<Threads>;
+            using Event     = graybat::communicationPolicy::Event<Threads>;
+            using EventSet  = graybat::communicationPolicy::EventSet<Threads>;
+            using Config    = graybat::communicationPolicy::Config<Threads>;
+            using Mailbox   = graybat::communicationPolicy::threads::Mailbox<Threads>;
+            using Hub       = graybat::communicationPolicy::threads::Hub<Threads>;
+            using Key       = typename Mailbox::Key;
+
+            Mailbox inBox;
+            std::shared_ptr<typename Hub::Group> group;
+            Context initialContext;
+
+	    Threads(Config const config) {
+                VAddr vAddr = 0;
+                std::tie(group, vAddr) = Hub::instance().join(config.contextName, config.contextSize, inBox);
+                initialContext = Context(group->contextID, vAddr, config.contextSize);
+
+	    }
+
+            // Copy constructor
+            Threads(Threads&) = delete;
+            // Copy assignment constructor
+            Threads& operator=(Threads&) = delete;
+            // Move constructor
+            Threads(Threads&&) = delete;
+            // Move assignment constructor
+            Threads& operator=(Threads&&) = delete;
+            // Destructor
+	    ~Threads(){
+                Hub::instance().leave(group);
+            }
+
+	    /***********************************************************************//**
+             *
+	     * @name Point to Point Communication Interface
+	     *
+	     * @{
+	     *
+	     ***************************************************************************/
+	    /**
+	     * @brief Blocking transmission of a message sendData to peer with virtual address destVAddr.
+	     *
+	     * @param[in] destVAddr  VAddr of peer that will receive the message
+	     * @param[in] tag        Description of the message to better distinguish messages types
+	     * @param[in] context    Context in which both sender and receiver are included
+	     * @param[in] sendData   Data reference of template type T will be send to receiver peer.
+	     *                       T need to provide the function data(), that returns the pointer
+	     *                       to the data memory address. And the function size(), that
+	     *                       return the amount of data elements to send. Notice, that
+	     *                       std::vector and std::array implement this interface.
+	     */
+	    template <typename T_Send>
+	    void send(const VAddr destVAddr, const Tag tag, const Context context, const T_Send& sendData){
+                sendImpl(MsgType::PEER, context, destVAddr, tag, sendData);
+
+	    }
+
+	    /**
+	     * @brief Non blocking transmission of a message sendData to peer with virtual address destVAddr.
+	     *        The data is delivered before this function returns, thus
+	     *        the returned event is always ready.
+	     *
+	     * @param[in] destVAddr  VAddr of peer that will receive the message
+	     * @param[in] tag        Description of the message to better distinguish messages types
+	     * @param[in] context    Context in which both sender and receiver are included
+	     * @param[in] sendData   Data reference of template type T will be.
+	     *                       T need to provide the function data(), that returns the pointer
+	     *                       to the data memory address. And the function size(), that
+	     *                       return the amount of data elements to send. Notice, that
+	     *                       std::vector and std::array implement this interface.
+	     *
+	     * @return Event
+	     */
+	    template <typename T_Send>
+	    Event asyncSend(const VAddr destVAddr, const Tag tag, const Context context, const T_Send& sendData){
+                sendImpl(MsgType::PEER, context, destVAddr, tag, sendData);
+                return Event(context, destVAddr, tag, *this);
+
+	    }
+
+	    /**
+	     * @brief Blocking receive of a message recvData from peer with virtual address srcVAddr.
+	     *
+	     * @param[in]  srcVAddr   VAddr of peer that sended the message
+	     * @param[in]  tag        Description of the message to better distinguish messages types
+	     * @param[in]  context    Context in which both sender and receiver are included
+	     * @param[out] recvData   Data reference of template type T will be received from sender peer.
+	     *                        T need to provide the function data(), that returns the pointer
+	     *                        to the data memory address. And the function size(), that
+	     *                        return the amount of data elements to send. Notice, that
+	     *                        std::vector and std::array implement this interface.
+	     */
+	    template <typename T_Recv>
+	    void recv(const VAddr srcVAddr, const Tag tag, const Context context, T_Recv& recvData){
+                recvImpl(MsgType::PEER, context, srcVAddr, tag,
+                         reinterpret_cast<std::int8_t*>(recvData.data()),
+                         sizeof(typename T_Recv::value_type) * recvData.size());
+
+	    }
+
+            template <typename T_Recv>
+	    Event recv(const Context context, T_Recv& recvData){
+                Key key = inBox.recv(MsgType::PEER, context.getID(),
+                                     reinterpret_cast<std::int8_t*>(recvData.data()),
+                                     sizeof(typename T_Recv::value_type) * recvData.size());
+                return Event(context, std::get<2>(key), std::get<3>(key), *this);
+
+	    }
+
+	    /**
+	     * @brief Non blocking receive of a message recvData from peer with virtual address srcVAddr.
+	     *
+	     * @param[in]  srcVAddr   VAddr of peer that sended the message
+	     * @param[in]  tag        Description of the message to better distinguish messages types
+	     * @param[in]  context    Context in which both sender and receiver are included
+	     * @param[out] recvData   Data reference of template type T will be received from sender peer.
+	     *                        T need to provide the function data(), that returns the pointer
+	     *                        to the data memory address. And the function size(), that
+	     *                        return the amount of data elements to send. Notice, that
+	     *                        std::vector and std::array implement this interface.
+	     *
+	     * @return Event
+	     *
+	     */
+	    template <typename T_Recv>
+	    Event asyncRecv(const VAddr srcVAddr, const Tag tag, const Context context, T_Recv& recvData){
+                std::shared_ptr<typename Mailbox::Posted> posted = asyncRecvImpl(MsgType::PEER, context, srcVAddr, tag,
+                                                                                 reinterpret_cast<std::int8_t*>(recvData.data()),
+                                                                                 sizeof(typename T_Recv::value_type) * recvData.size());
+                return Event(context, srcVAddr, tag, std::move(posted), *this);
+
+	    }
+
+	    /** @} */
+
+	    /************************************************************************//**
+	     *
+	     * @name Context Interface
+	     *
+	     * @{
+	     *
+	     **************************************************************************/
+	    /**
+	     * @brief Creates a new context from peer *oldContext* if isMember is true.
+	     *
+	     * Peers keep their virtual addresses of the old context in
+	     * the new context.
+	     *
+	     * @param[in] isMember   Flag which marks peers which will be part of the new context
+	     * @param[in] oldContext Context which contains all peers, that will be part of the new context
+	     *
+	     * @return New context or invalid context if isMember was false
+	     */
+	    Context splitContext(const bool isMember, const Context oldContext){
+                VAddr const masterVAddr = *oldContext.begin();
+
+                std::array<unsigned, 1> member {{ isMember }};
+                sendImpl(MsgType::SPLIT, oldContext, masterVAddr, 0, member);
+
+                if(oldContext.getVAddr() == masterVAddr){
+                    std::vector<VAddr> newContextWhiteList;
+                    for(auto const &vAddr : oldContext){
+                        std::array<unsigned, 1> remoteIsMember {{ 0 }};
+                        recvImpl(MsgType::SPLIT, oldContext, vAddr, 0, remoteIsMember);
+                        if(remoteIsMember[0]){
+                            newContextWhiteList.push_back(vAddr);
+                        }
+                    }
+
+                    std::array<unsigned, 2> newContextInfo {{ Hub::instance().getContextID(), static_cast<unsigned>(newContextWhiteList.size()) }};
+                    for(VAddr vAddr : newContextWhiteList){
+                        sendImpl(MsgType::SPLIT, oldContext, vAddr, 0, newContextInfo);
+                        sendImpl(MsgType::SPLIT, oldContext, vAddr, 0, newContextWhiteList);
+                    }
+
+                }
+
+                if(isMember){
+                    std::array<unsigned, 2> newContextInfo {{ 0, 0 }};
+                    recvImpl(MsgType::SPLIT, oldContext, masterVAddr, 0, newContextInfo);
+                    std::vector<VAddr> newContextWhiteList(newContextInfo[1]);
+                    recvImpl(MsgType::SPLIT, oldContext, masterVAddr, 0, newContextWhiteList);
+
+                    return Context(newContextInfo[0], oldContext.getVAddr(), newContextWhiteList);
+                }
+
+                return Context();
+
+	    }
+
+	    /**
+	     * @brief Returns the context that contains all peers
+	     *
+	     */
+	    Context getGlobalContext(){
+	    	return initialContext;
+	    }
+
+	    /** @} */
+
+            // Auxilary
+            template <typename T_Send>
+            void sendImpl(MsgType const msgType, Context const context, VAddr const destVAddr, Tag const tag, T_Send const & sendData){
+                group->peers.at(destVAddr)->deliver(Key(msgType, context.getID(), context.getVAddr(), tag),
+                                                    reinterpret_cast<std::int8_t const*>(sendData.data()),
+                                                    sizeof(typename T_Send::value_type) * sendData.size());
+
+            }
+
+            template <typename T_Recv>
+            void recvImpl(MsgType const msgType, Context const context, VAddr const srcVAddr, Tag const tag, T_Recv & recvData){
+                recvImpl(msgType, context, srcVAddr, tag,
+                         reinterpret_cast<std::int8_t*>(recvData.data()),
+                         sizeof(typename T_Recv::value_type) * recvData.size());
+
+            }
+
+            void recvImpl(MsgType const msgType, Context const context, VAddr const srcVAddr, Tag const tag, std::int8_t * recvData, size_t const size){
+                inBox.recv(Key(msgType, context.getID(), srcVAddr, tag), recvData, size);
+
+            }
+
+            std::shared_ptr<typename Mailbox::Posted> asyncRecvImpl(MsgType const msgType, Context const context, VAddr const srcVAddr, Tag const tag, std::int8_t * recvData, size_t const size){
+                return inBox.post(Key(msgType, context.getID(), srcVAddr, tag), recvData, size);
+
+            }
+
+	}; // struct Threads
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
@@ -20,6 +20,10 @@
 
 #pragma once
 
+// STL
+#include <functional>  /* std::plus, std::multiplies, ... */
+#include <type_traits> /* std::true_type, std::false_type */
+
 namespace graybat {
     
     namespace communicationPolicy {
@@ -35,8 +39,57 @@ namespace graybat {
             template <typename T_CommunicationPolicy>
             struct EventType;
 
+            template <typename T_CommunicationPolicy>
+            struct EventSetType;
+
             template <typename T_CommunicationPolicy>
             struct ConfigType;
+
+        } // namespace traits
+
+        template <typename T_CommunicationPolicy>
+        class DisseminationBarrier;
+
+        namespace traits {
+
+            /**
+             * @brief Split-phase barrier of a policy, policies
+             *        without a native one use the DisseminationBarrier.
+             */
+            template <typename T_CommunicationPolicy>
+            struct BarrierType {
+                using type = DisseminationBarrier<T_CommunicationPolicy>;
+            };
+
+            /**
+             * @brief Reduction operators whose operands may be combined
+             *        in any order. Collectives that reorder the operands
+             *        are only used for these, further operators opt in
+             *        by specializing the trait.
+             */
+            template <typename T_Op>
+            struct IsCommutative : std::false_type {};
+
+            template <typename T>
+            struct IsCommutative<std::plus<T> > : std::true_type {};
+
+            template <typename T>
+            struct IsCommutative<std::multiplies<T> > : std::true_type {};
+
+            template <typename T>
+            struct IsCommutative<std::logical_and<T> > : std::true_type {};
+
+            template <typename T>
+            struct IsCommutative<std::logical_or<T> > : std::true_type {};
+
+            template <typename T>
+            struct IsCommutative<std::bit_and<T> > : std::true_type {};
+
+            template <typename T>
+            struct IsCommutative<std::bit_or<T> > : std::true_type {};
+
+            template <typename T>
+            struct IsCommutative<std::bit_xor<T> > : std::true_type {};
             
         } // namespace traits
 
@@ -55,8 +108,10 @@ namespace graybat {
                 CONTEXT_INIT = 5,
                 CONTEXT_REQUEST = 6,
                 PEER = 7,
-                CONFIRM = 8,
-                SPLIT = 9};
+                CREDIT = 8,
+                SPLIT = 9,
+                CHUNK = 10,
+                BATCH = 11};
         
         template <typename T_CommunicationPolicy>
         using MsgType = MsgTypeType;
@@ -74,8 +129,14 @@ namespace graybat {
         template <typename T_CommunicationPolicy>
         using Event = typename traits::EventType<T_CommunicationPolicy>::type;
 
+        template <typename T_CommunicationPolicy>
+        using EventSet = typename traits::EventSetType<T_CommunicationPolicy>::type;
+
         template <typename T_CommunicationPolicy>
         using Config = typename traits::ConfigType<T_CommunicationPolicy>::type;
+
+        template <typename T_CommunicationPolicy>
+        using Barrier = typename traits::BarrierType<T_CommunicationPolicy>::type;
         
     } // namespace communicationPolicy
     
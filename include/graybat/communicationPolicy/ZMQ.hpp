@@ -29,6 +29,13 @@
 #include <array>      /* array */
 #include <iostream>   /* std::cout */
 #include <map>        /* std::map */
+#include <deque>      /* std::deque */
+#include <atomic>     /* std::atomic */
+#include <cstdint>    /* std::uint64_t */
+#include <memory>     /* std::shared_ptr */
+#include <tuple>      /* std::tuple */
+#include <functional> /* std::less */
+#include <algorithm>  /* std::max */
 #include <exception>  /* std::out_of_range */
 #include <sstream>    /* std::stringstream, std::istringstream */
 #include <string>     /* std::string */
@@ -42,7 +49,9 @@
 #include <graybat/communicationPolicy/zmq/Message.hpp> /* Message */
 #include <graybat/communicationPolicy/zmq/Context.hpp> /* Context */
 #include <graybat/communicationPolicy/zmq/Event.hpp>   /* Event */
+#include <graybat/communicationPolicy/zmq/EventSet.hpp> /* EventSet */
 #include <graybat/communicationPolicy/zmq/Config.hpp>  /* Config */
+#include <graybat/communicationPolicy/zmq/Stripe.hpp>  /* StripeInfo, StripeOwner */
 
 
 namespace graybat {
@@ -55,6 +64,12 @@ namespace graybat {
 	 * @brief Implementation of the Cage communicationPolicy interface
 	 *        based on ZMQ.
 	 *
+	 * Payloads larger than Config::stripeThreshold are split into one
+	 * stripe per stream. Stripe 0 travels on the regular connection to
+	 * the peer, thus the order of messages between two peers is kept,
+	 * the other stripes on additional connections. The receiver hands
+	 * out messages in the order their first stripe arrived.
+	 *
 	 ***************************************************************************/
         struct ZMQ;
 
@@ -75,6 +90,11 @@ namespace graybat {
                 using type = graybat::communicationPolicy::zmq::Event<ZMQ>;
             };
 
+            template<>
+            struct EventSetType<ZMQ> {
+                using type = graybat::communicationPolicy::zmq::EventSet<ZMQ>;
+            };
+
             template<>
             struct ConfigType<ZMQ> {
                 using type = graybat::communicationPolicy::zmq::Config;
@@ -115,6 +135,7 @@ namespace graybat {
             using VAddr      = graybat::communicationPolicy::VAddr<ZMQ>;
             using Context    = graybat::communicationPolicy::Context<ZMQ>;
             using Event      = graybat::communicationPolicy::Event<ZMQ>;
+            using EventSet   = graybat::communicationPolicy::EventSet<ZMQ>;
             using Config     = graybat::communicationPolicy::Config<ZMQ>;
             using MsgType    = graybat::communicationPolicy::MsgType<ZMQ>;
             using Uri        = graybat::communicationPolicy::socket::Uri<ZMQ>;
@@ -130,6 +151,21 @@ namespace graybat {
             std::vector<Socket> sendSockets;
             std::vector<Socket> ctrlSendSockets;                        
 
+            // Additional connections per peer for striped payloads
+            const size_t streams;
+            const size_t stripeThreshold;
+            std::vector<std::vector<Socket> > stripeSendSockets;
+            std::atomic<std::uint64_t> stripeSequence;
+
+            // Messages in order of their first stripe and the
+            // striped messages that are not complete yet
+            struct Assembly {
+                Message message;
+                size_t remaining;
+            };
+            std::deque<std::shared_ptr<Assembly> > arrived;
+            std::map<std::tuple<ContextID, VAddr, std::uint64_t>, std::shared_ptr<Assembly> > assemblies;
+
             // Uri
 	    const Uri peerUri;
             const Uri ctrlUri;
@@ -138,16 +174,26 @@ namespace graybat {
             // Construct
 	    ZMQ(Config const config) :
                 SocketBase(config),
-		zmqContext(1),
+		zmqContext(std::max(config.ioThreads, 1)),
                 recvSocket(zmqContext, ZMQ_PULL),
                 ctrlSocket(zmqContext, ZMQ_PULL),                
 		signalingSocket(zmqContext, ZMQ_REQ),
+                streams(std::max<size_t>(config.streams, 1)),
+                stripeThreshold(config.stripeThreshold),
+                stripeSequence(0),
                 peerUri(bindToNextFreePort(recvSocket, config.peerUri)),
                 ctrlUri(bindToNextFreePort(ctrlSocket, config.peerUri))                
             {
 
                 //std::cout << "PeerUri: " << peerUri << std::endl;
+                zeroCopy = config.zeroCopy;
                 SocketBase::init();
+
+                for(auto const &vAddr : initialContext){
+                    for(Socket &socket : stripeSendSockets.at(vAddr)){
+                        connectToSocket(socket, phoneBook.at(initialContext.getID()).at(vAddr));
+                    }
+                }
                 
             }
 
@@ -178,6 +224,10 @@ namespace graybat {
                 (void)vAddr;
                 sendSockets.emplace_back(Socket(zmqContext, ZMQ_PUSH));
                 ctrlSendSockets.emplace_back(Socket(zmqContext, ZMQ_PUSH));
+                stripeSendSockets.emplace_back();
+                for(size_t stream_i = 1; stream_i < streams; ++stream_i){
+                    stripeSendSockets.back().emplace_back(Socket(zmqContext, ZMQ_PUSH));
+                }
             }
         }
             
@@ -196,7 +246,72 @@ namespace graybat {
 
             template <typename T_Socket>            
 	    void recvFromSocket(T_Socket& socket, Message & message) {
-                socket.recv(&message.getMessage());                
+                socket.recv(&message.getHeader());
+                if(message.getHeader().more()){
+                    socket.recv(&message.getPayload());
+                }
+	    }
+
+            /**
+             * @brief Hands out the header of the next message. Its payload
+             *        is either still waiting in the socket or, when the
+             *        message had to be reassembled or queued behind a
+             *        striped message, already part of *message*.
+             */
+            template <typename T_Socket>
+	    void recvHeaderFromSocket(T_Socket& socket, Message & message) {
+                while(true){
+                    if(!arrived.empty() && arrived.front()->remaining == 0){
+                        message = std::move(arrived.front()->message);
+                        arrived.pop_front();
+                        return;
+                    }
+
+                    ::zmq::message_t header;
+                    socket.recv(&header);
+
+                    if(header.size() == Message::headerSize){
+                        if(arrived.empty()){
+                            message.getHeader().move(&header);
+                            return;
+                        }
+
+                        // Keep the order behind a striped message
+                        std::shared_ptr<Assembly> assembly = std::make_shared<Assembly>();
+                        assembly->message.getHeader().move(&header);
+                        recvPayloadFromSocket(socket, assembly->message);
+                        assembly->message.assembled = true;
+                        assembly->remaining = 0;
+                        arrived.push_back(assembly);
+                    }
+                    else {
+                        recvStripe(socket, header);
+                    }
+                }
+	    }
+
+            template <typename T_Socket>
+	    void recvPayloadFromSocket(T_Socket& socket, Message & message) {
+                if(!message.assembled && message.getHeader().more()){
+                    socket.recv(&message.getPayload());
+                }
+	    }
+
+            /**
+             * @brief Receives the payload frame straight into *data*,
+             *        bytes beyond *size* are truncated by zmq.
+             */
+            template <typename T_Socket>
+	    void recvPayloadFromSocket(T_Socket& socket, Message & message, std::int8_t * data, size_t const size) {
+                if(message.assembled){
+                    size_t const n = std::min(size, message.getPayload().size());
+                    if(n > 0){
+                        memcpy (data, message.getPayload().data(), n);
+                    }
+                }
+                else if(message.getHeader().more()){
+                    socket.recv(data, size);
+                }
 	    }
 
             template <typename T_Socket>
@@ -212,6 +327,101 @@ namespace graybat {
                 socket.send(data);
             }
 
+            template <typename T_Socket>
+	    void sendToSocket(T_Socket& socket, Message & message) {
+                std::vector<Socket> * stripeSockets = stripeSocketsOf(socket);
+                if(stripeSockets != nullptr && message.getPayload().size() > stripeThreshold){
+                    sendStriped(socket, *stripeSockets, message);
+                }
+                else {
+                    socket.send(message.getHeader(), ZMQ_SNDMORE);
+                    socket.send(message.getPayload());
+                }
+            }
+
+            /**
+             * @brief Returns the additional connections of a data socket
+             *        to a peer, or nullptr for any other socket.
+             */
+            std::vector<Socket> * stripeSocketsOf(Socket & socket) {
+                std::less<Socket const*> less;
+                if(streams > 1 && !sendSockets.empty() &&
+                   !less(&socket, sendSockets.data()) && less(&socket, sendSockets.data() + sendSockets.size())){
+                    return &stripeSendSockets.at(&socket - sendSockets.data());
+                }
+                return nullptr;
+            }
+
+            /**
+             * @brief Sends the payload of *message* as one stripe per stream.
+             *        The stripe frames refer to the payload, which is kept
+             *        alive until zmq released all of them.
+             */
+            void sendStriped(Socket & socket, std::vector<Socket> & stripeSockets, Message & message) {
+                size_t const total = message.getPayload().size();
+                std::uint32_t const count = static_cast<std::uint32_t>(std::min(streams, total));
+                std::uint64_t const sequence = stripeSequence++;
+
+                zmq::StripeOwner * owner = new zmq::StripeOwner(count);
+                owner->payload.move(&message.getPayload());
+                std::int8_t * payload = static_cast<std::int8_t*>(owner->payload.data());
+
+                for(std::uint32_t stripe_i = 0; stripe_i < count; ++stripe_i){
+                    zmq::StripeInfo info;
+                    info.index  = stripe_i;
+                    info.count  = count;
+                    info.offset = total * stripe_i / count;
+                    info.size   = total * (stripe_i + 1) / count - info.offset;
+                    info.total  = total;
+                    info.sequence = sequence;
+
+                    ::zmq::message_t header(Message::headerSize + sizeof(zmq::StripeInfo));
+                    memcpy (static_cast<char*>(header.data()), message.getHeader().data(), Message::headerSize);
+                    memcpy (static_cast<char*>(header.data()) + Message::headerSize, &info, sizeof(zmq::StripeInfo));
+                    ::zmq::message_t part(payload + info.offset, info.size, &zmq::StripeOwner::release, owner);
+
+                    Socket & stream = stripe_i == 0 ? socket : stripeSockets.at(stripe_i - 1);
+                    stream.send(header, ZMQ_SNDMORE);
+                    stream.send(part);
+                }
+
+            }
+
+            /**
+             * @brief Receives one stripe into the payload of its message.
+             */
+            template <typename T_Socket>
+            void recvStripe(T_Socket & socket, ::zmq::message_t & header) {
+                zmq::StripeInfo info;
+                memcpy (&info, static_cast<char*>(header.data()) + Message::headerSize, sizeof(zmq::StripeInfo));
+
+                Message stripe;
+                stripe.getHeader().rebuild(Message::headerSize);
+                memcpy (stripe.getHeader().data(), header.data(), Message::headerSize);
+                auto const key = std::make_tuple(stripe.getContextID(), stripe.getVAddr(), info.sequence);
+
+                std::shared_ptr<Assembly> assembly = assemblies[key];
+                if(!assembly){
+                    assembly = std::make_shared<Assembly>();
+                    assembly->message.getHeader().move(&stripe.getHeader());
+                    assembly->message.getPayload().rebuild(info.total);
+                    assembly->message.assembled = true;
+                    assembly->remaining = info.count;
+                    assemblies[key] = assembly;
+                }
+
+                socket.recv(static_cast<std::int8_t*>(assembly->message.getPayload().data()) + info.offset, info.size);
+
+                if(info.index == 0){
+                    arrived.push_back(assembly);
+                }
+
+                if(--assembly->remaining == 0){
+                    assemblies.erase(key);
+                }
+
+            }
+
 	    Uri bindToNextFreePort(Socket &socket, const std::string peerUri){
 		std::string peerBaseUri = peerUri.substr(0, peerUri.rfind(":"));
 		unsigned peerBasePort   = std::stoi(peerUri.substr(peerUri.rfind(":") + 1));		
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <utility> /* std::swap */
+
+// MPI
+#include <mpi.h>  /* MPI_* */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace bmpi {
+
+            /**
+             * @brief Split-phase barrier started by MPI_Ibarrier
+             *        through BMPI::asyncSynchronize.
+             *
+             */
+            class Barrier {
+            public:
+                Barrier() :
+                    request(MPI_REQUEST_NULL){
+
+                }
+
+                Barrier(Barrier &&other) :
+                    request(other.request){
+                    other.request = MPI_REQUEST_NULL;
+                }
+
+                Barrier& operator=(Barrier &&other){
+                    std::swap(request, other.request);
+                    return *this;
+                }
+
+                Barrier(Barrier &) = delete;
+                Barrier& operator=(Barrier &) = delete;
+
+                ~Barrier(){
+                    wait();
+                }
+
+                /**
+                 * @brief Blocks until all peers arrived.
+                 */
+                void wait(){
+                    if(request != MPI_REQUEST_NULL){
+                        MPI_Wait(&request, MPI_STATUS_IGNORE);
+                    }
+                }
+
+                bool ready(){
+                    int flag = 1;
+                    if(request != MPI_REQUEST_NULL){
+                        MPI_Test(&request, &flag, MPI_STATUS_IGNORE);
+                    }
+                    return flag != 0;
+                }
+
+                MPI_Request request;
+
+            };
+
+        } // namespace bmpi
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
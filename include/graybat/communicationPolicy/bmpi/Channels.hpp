@@ -0,0 +1,117 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <utility> /* std::move, std::swap */
+#include <vector>  /* std::vector */
+
+// MPI
+#include <mpi.h>  /* MPI_* */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace bmpi {
+
+            /**
+             * @brief Set of persistent send and receive requests. The
+             *        requests are created once by BMPI::sendInit and
+             *        BMPI::recvInit and started together every time
+             *        the same messages are exchanged again. The buffers
+             *        the requests were created with have to stay valid
+             *        as long as the channels exist.
+             *
+             */
+            class Channels {
+            public:
+                Channels(){
+
+                }
+
+                Channels(Channels &&other) :
+                    requests(std::move(other.requests)){
+                    other.requests.clear();
+                }
+
+                Channels& operator=(Channels &&other){
+                    std::swap(requests, other.requests);
+                    return *this;
+                }
+
+                Channels(Channels &) = delete;
+                Channels& operator=(Channels &) = delete;
+
+                ~Channels(){
+                    for(MPI_Request &request : requests){
+                        if(request != MPI_REQUEST_NULL){
+                            MPI_Request_free(&request);
+                        }
+                    }
+                }
+
+                void add(MPI_Request const request){
+                    requests.push_back(request);
+                }
+
+                std::size_t size() const {
+                    return requests.size();
+                }
+
+                /**
+                 * @brief Starts all requests with MPI_Startall.
+                 */
+                void start(){
+                    if(!requests.empty()){
+                        MPI_Startall(static_cast<int>(requests.size()), requests.data());
+                    }
+                }
+
+                /**
+                 * @brief Waits with MPI_Waitall until all started requests
+                 *        finished. The requests stay allocated.
+                 */
+                void wait(){
+                    if(!requests.empty()){
+                        MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+                    }
+                }
+
+                bool ready(){
+                    int flag = 0;
+                    if(!requests.empty()){
+                        MPI_Testall(static_cast<int>(requests.size()), requests.data(), &flag, MPI_STATUSES_IGNORE);
+                        return flag != 0;
+                    }
+                    return true;
+                }
+
+            private:
+                std::vector<MPI_Request> requests;
+
+            };
+
+        } // namespace bmpi
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
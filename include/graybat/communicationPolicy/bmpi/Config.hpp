@@ -20,6 +20,9 @@
 
 #pragma once
 
+// BOOST
+#include <boost/mpi/environment.hpp> /* boost::mpi::threading */
+
 namespace graybat {
     
     namespace communicationPolicy {
@@ -27,7 +30,9 @@ namespace graybat {
         namespace bmpi {
 
             struct Config {
-
+                // Thread support requested from MPI, multiple allows
+                // to communicate from several threads at the same time
+                boost::mpi::threading::level threadLevel = boost::mpi::threading::single;
             };
 
         } // bmpi
@@ -20,6 +20,9 @@
 
 #pragma once
 
+// STL
+#include <cstddef> /* std::size_t */
+
 // BOOST
 #include <boost/mpi/environment.hpp>
 
@@ -82,6 +85,21 @@ namespace graybat {
 		    return isValid;
 		}
 
+		/**
+		 * @brief Position of *vAddr* in the member list, which
+		 *        equals the rank in the communicator.
+		 */
+		std::size_t rankOf(VAddr const vAddr) const {
+		    return vAddr;
+		}
+
+		/**
+		 * @brief VAddr of the member at position *rank*.
+		 */
+		VAddr vAddrOf(std::size_t const rank) const {
+		    return static_cast<VAddr>(rank);
+		}
+
                 VAddrIterator<T_CP> begin(){
                     return VAddrIterator<T_CP>(0);
                 }
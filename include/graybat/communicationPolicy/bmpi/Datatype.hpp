@@ -0,0 +1,116 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <type_traits> /* std::decay */
+#include <vector>      /* std::vector */
+
+// BOOST
+#include <boost/mpi/datatype.hpp>
+
+// MPI
+#include <mpi.h>  /* MPI_* */
+
+// GRAYBAT
+#include <graybat/utils/Members.hpp> /* utils::forEachMember */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace bmpi {
+
+            /**
+             * @brief Builds a committed MPI struct datatype from the
+             *        members of the reflectable type *T*. The extent
+             *        is resized to sizeof(T), so that arrays of *T*
+             *        are described including their padding.
+             */
+            template <typename T>
+            MPI_Datatype createStructDatatype(){
+                T object{};
+                MPI_Aint base = 0;
+                MPI_Get_address(&object, &base);
+
+                std::vector<int>          lengths;
+                std::vector<MPI_Aint>     displacements;
+                std::vector<MPI_Datatype> types;
+
+                utils::forEachMember(object, [base, &lengths, &displacements, &types](auto &member){
+                        using Member = typename std::decay<decltype(member)>::type;
+                        MPI_Aint address = 0;
+                        MPI_Get_address(&member, &address);
+                        lengths.push_back(1);
+                        displacements.push_back(address - base);
+                        types.push_back(boost::mpi::get_mpi_datatype<Member>(member));
+                    });
+
+                MPI_Datatype structType = MPI_DATATYPE_NULL;
+                MPI_Type_create_struct(static_cast<int>(types.size()), lengths.data(), displacements.data(), types.data(), &structType);
+
+                MPI_Datatype datatype = MPI_DATATYPE_NULL;
+                MPI_Type_create_resized(structType, 0, sizeof(T), &datatype);
+                MPI_Type_free(&structType);
+                MPI_Type_commit(&datatype);
+                return datatype;
+
+            }
+
+            /**
+             * @brief Struct datatype of *T*, created on first use and
+             *        cached for the rest of the program.
+             */
+            template <typename T>
+            MPI_Datatype structDatatype(){
+                static MPI_Datatype const datatype = createStructDatatype<T>();
+                return datatype;
+            }
+
+        } // namespace bmpi
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
+
+/**
+ * @brief Declares the Hana adapted struct or std::tuple given as
+ *        argument as MPI datatype. Boost.MPI and BMPI then transmit
+ *        it with a cached struct datatype instead of serializing it.
+ *        Has to be used in the global namespace before the type is
+ *        communicated the first time.
+ *
+ * @code
+ * GRAYBAT_MPI_DATATYPE(std::tuple<int, int, int>)
+ * @endcode
+ */
+#define GRAYBAT_MPI_DATATYPE(...)                                                   \
+    namespace boost {                                                               \
+        namespace mpi {                                                             \
+            template <>                                                             \
+            struct is_mpi_datatype< __VA_ARGS__ > : mpl::true_ {};                  \
+                                                                                    \
+            template <>                                                             \
+            inline MPI_Datatype get_mpi_datatype< __VA_ARGS__ >(__VA_ARGS__ const &){ \
+                return graybat::communicationPolicy::bmpi::structDatatype< __VA_ARGS__ >(); \
+            }                                                                       \
+        }                                                                           \
+    }
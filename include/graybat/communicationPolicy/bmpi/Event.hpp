@@ -28,6 +28,7 @@ namespace graybat {
 
         namespace bmpi {
 
+            class EventSet;
 
             /**
              * @brief An event is returned by non-blocking
@@ -94,6 +95,8 @@ namespace graybat {
                 }
 
             private:
+                friend class EventSet;
+
                 boost::mpi::request request;
                 boost::mpi::status  status;
                 bool async;
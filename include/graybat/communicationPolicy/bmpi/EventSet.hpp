@@ -0,0 +1,128 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef>   /* std::size_t */
+#include <iterator>  /* std::back_inserter */
+#include <stdexcept> /* std::runtime_error */
+#include <utility>   /* std::move */
+#include <vector>    /* std::vector */
+
+// BOOST
+#include <boost/mpi/nonblocking.hpp>
+
+// graybat
+#include <graybat/communicationPolicy/bmpi/Event.hpp>
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace bmpi {
+
+            /**
+             * @brief Set of events of the MPI policy. The requests of the
+             *        events are completed together by MPI_Waitall,
+             *        MPI_Waitany and MPI_Testsome.
+             *
+             */
+            class EventSet {
+            public:
+
+                void push_back(Event const &event){
+                    if(event.async){
+                        requests.push_back(event.request);
+                    }
+                    else {
+                        finished.push_back(event);
+                    }
+                }
+
+                std::size_t size() const {
+                    return requests.size() + finished.size();
+                }
+
+                bool empty() const {
+                    return requests.empty() && finished.empty();
+                }
+
+                /**
+                 * @brief Waits for all events and clears the set.
+                 */
+                void waitAll(){
+                    boost::mpi::wait_all(requests.begin(), requests.end());
+                    requests.clear();
+                    finished.clear();
+
+                }
+
+                /**
+                 * @brief Waits until one event finished, removes it from
+                 *        the set and returns it.
+                 */
+                Event waitAny(){
+                    if(!finished.empty()){
+                        Event event = finished.back();
+                        finished.pop_back();
+                        return event;
+                    }
+
+                    if(requests.empty()){
+                        throw std::runtime_error("waitAny on an empty EventSet.");
+                    }
+
+                    auto result = boost::mpi::wait_any(requests.begin(), requests.end());
+                    requests.erase(result.second);
+                    return Event(result.first);
+
+                }
+
+                /**
+                 * @brief Removes all finished events from the set and
+                 *        returns them, does not block.
+                 */
+                std::vector<Event> testSome(){
+                    std::vector<Event> result = std::move(finished);
+                    finished.clear();
+
+                    std::vector<boost::mpi::status> statuses;
+                    auto done = boost::mpi::test_some(requests.begin(), requests.end(), std::back_inserter(statuses));
+                    requests.erase(done.second, requests.end());
+
+                    for(boost::mpi::status const &status : statuses){
+                        result.push_back(Event(status));
+                    }
+                    return result;
+
+                }
+
+            private:
+                std::vector<boost::mpi::request> requests;
+                std::vector<Event> finished;
+
+            };
+
+        } // namespace bmpi
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
@@ -0,0 +1,134 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <utility> /* std::move, std::swap */
+#include <vector>  /* std::vector */
+
+// BOOST
+#include <boost/mpi/communicator.hpp>
+
+// MPI
+#include <mpi.h>  /* MPI_* */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace bmpi {
+
+            /**
+             * @brief Distributed graph communicator of the peers a peer
+             *        exchanges data with, created once by
+             *        BMPI::createNeighborhood. A neighborhood exchange
+             *        sends one block to every destination and receives
+             *        one block from every source in a single
+             *        MPI_Neighbor_alltoallv.
+             *
+             * The count and displacement arrays are kept by the
+             * neighborhood, so that they are valid until a started
+             * non-blocking exchange has finished.
+             *
+             */
+            class Neighborhood {
+            public:
+                Neighborhood() :
+                    request(MPI_REQUEST_NULL){
+
+                }
+
+                Neighborhood(boost::mpi::communicator comm, std::size_t const nSources, std::size_t const nDestinations) :
+                    comm(comm),
+                    sendCounts(nDestinations, 0),
+                    sendDispls(nDestinations, 0),
+                    recvCounts(nSources, 0),
+                    recvDispls(nSources, 0),
+                    request(MPI_REQUEST_NULL){
+
+                }
+
+                Neighborhood(Neighborhood &&other) :
+                    comm(other.comm),
+                    sendCounts(std::move(other.sendCounts)),
+                    sendDispls(std::move(other.sendDispls)),
+                    recvCounts(std::move(other.recvCounts)),
+                    recvDispls(std::move(other.recvDispls)),
+                    request(other.request){
+                    other.request = MPI_REQUEST_NULL;
+                }
+
+                Neighborhood& operator=(Neighborhood &&other){
+                    std::swap(comm, other.comm);
+                    std::swap(sendCounts, other.sendCounts);
+                    std::swap(sendDispls, other.sendDispls);
+                    std::swap(recvCounts, other.recvCounts);
+                    std::swap(recvDispls, other.recvDispls);
+                    std::swap(request, other.request);
+                    return *this;
+                }
+
+                Neighborhood(Neighborhood &) = delete;
+                Neighborhood& operator=(Neighborhood &) = delete;
+
+                ~Neighborhood(){
+                    wait();
+                }
+
+                /**
+                 * @brief Waits until a started non-blocking exchange finished.
+                 */
+                void wait(){
+                    if(request != MPI_REQUEST_NULL){
+                        MPI_Wait(&request, MPI_STATUS_IGNORE);
+                    }
+                }
+
+                bool ready(){
+                    int flag = 1;
+                    if(request != MPI_REQUEST_NULL){
+                        MPI_Test(&request, &flag, MPI_STATUS_IGNORE);
+                    }
+                    return flag != 0;
+                }
+
+                std::size_t nSources() const {
+                    return recvCounts.size();
+                }
+
+                std::size_t nDestinations() const {
+                    return sendCounts.size();
+                }
+
+                boost::mpi::communicator comm;
+                std::vector<int> sendCounts;
+                std::vector<int> sendDispls;
+                std::vector<int> recvCounts;
+                std::vector<int> recvDispls;
+                MPI_Request request;
+
+            };
+
+        } // namespace bmpi
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
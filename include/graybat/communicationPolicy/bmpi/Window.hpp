@@ -0,0 +1,132 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstdint> /* std::int8_t */
+#include <utility> /* std::swap */
+
+// MPI
+#include <mpi.h>  /* MPI_* */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace bmpi {
+
+            /**
+             * @brief Memory of a peer exposed for one-sided access,
+             *        created by BMPI::createWindow. Remote peers write
+             *        into it with BMPI::put, the writes become visible
+             *        when the surrounding fence or PSCW epoch closed.
+             *
+             * The groups of peers that access this window (origins)
+             * and whose windows this peer accesses (targets) are fixed
+             * at creation, so that opening a PSCW epoch does not
+             * create groups.
+             *
+             */
+            class Window {
+            public:
+                Window() :
+                    window(MPI_WIN_NULL),
+                    origins(MPI_GROUP_NULL),
+                    targets(MPI_GROUP_NULL),
+                    base(nullptr),
+                    nBytes(0){
+
+                }
+
+                Window(MPI_Win const window, MPI_Group const origins, MPI_Group const targets, void * const base, std::size_t const nBytes) :
+                    window(window),
+                    origins(origins),
+                    targets(targets),
+                    base(static_cast<std::int8_t*>(base)),
+                    nBytes(nBytes){
+
+                }
+
+                Window(Window &&other) :
+                    Window(){
+                    swap(other);
+                }
+
+                Window& operator=(Window &&other){
+                    swap(other);
+                    return *this;
+                }
+
+                Window(Window &) = delete;
+                Window& operator=(Window &) = delete;
+
+                ~Window(){
+                    int finalized = 0;
+                    MPI_Finalized(&finalized);
+                    if(finalized){
+                        return;
+                    }
+                    if(origins != MPI_GROUP_NULL && origins != MPI_GROUP_EMPTY){
+                        MPI_Group_free(&origins);
+                    }
+                    if(targets != MPI_GROUP_NULL && targets != MPI_GROUP_EMPTY){
+                        MPI_Group_free(&targets);
+                    }
+                    if(window != MPI_WIN_NULL){
+                        MPI_Win_free(&window);
+                    }
+                }
+
+                std::int8_t* data(){
+                    return base;
+                }
+
+                std::size_t size() const {
+                    return nBytes;
+                }
+
+                bool valid() const {
+                    return window != MPI_WIN_NULL;
+                }
+
+                MPI_Win window;
+                MPI_Group origins;
+                MPI_Group targets;
+
+            private:
+                std::int8_t* base;
+                std::size_t nBytes;
+
+                void swap(Window &other){
+                    std::swap(window, other.window);
+                    std::swap(origins, other.origins);
+                    std::swap(targets, other.targets);
+                    std::swap(base, other.base);
+                    std::swap(nBytes, other.nBytes);
+                }
+
+            };
+
+        } // namespace bmpi
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
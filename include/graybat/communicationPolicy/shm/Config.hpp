@@ -0,0 +1,60 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <graybat/communicationPolicy/socket/Wait.hpp> /* WaitStrategy */
+
+namespace graybat {
+    
+    namespace communicationPolicy {
+    
+        namespace shm {
+
+            struct Config {
+
+                std::string masterUri;
+                size_t contextSize;
+                std::string contextName = "context";
+                size_t maxBufferSize = 100 * 1000 * 1000;
+                // Peer messages that may be in flight to one peer before
+                // the sender waits for credits granted by the receiver
+                size_t credits = 64;
+                // Peer messages above chunkSize bytes are sent as a
+                // sequence of chunks, each chunk takes one credit
+                size_t chunkSize = 4 * 1024 * 1024;
+                // Peer messages up to coalesceThreshold bytes are packed
+                // into frames of up to coalesceSize bytes per destination.
+                // A frame is sent when full, when it is older than the
+                // adaptive delay (at most coalesceDelay microseconds) or
+                // on flush. A coalesceSize of 0 disables coalescing.
+                size_t coalesceSize = 64 * 1024;
+                size_t coalesceThreshold = 1024;
+                size_t coalesceDelay = 100;
+                // How events are waited for when no strategy is given
+                socket::WaitStrategy waitStrategy {};
+                size_t ringSize = 8 * 1024 * 1024;
+            };
+
+        } // shm
+        
+    } // namespace communicationPolicy
+	
+} // namespace graybat
@@ -0,0 +1,191 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstdint> /* std::int8_t */
+#include <cstring> /* memcpy */
+#include <vector>  /* std::vector */
+
+#include <graybat/communicationPolicy/Traits.hpp>
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace shm {
+
+            /**
+             * @brief Message of the shared memory policy.
+             *
+             * A received message owns its bytes (header followed by
+             * payload). A message that is going to be sent only owns
+             * its header and refers to the payload of the caller, which
+             * is copied straight into the ring of the receiver.
+             * A message whose header was read on its own keeps track of
+             * the payload bytes still waiting in the ring.
+             *
+             */
+            template <typename T_CommunicationPolicy>
+            struct Message {
+
+                // Types
+                using CommunicationPolicy = T_CommunicationPolicy;
+                using ContextID           = typename graybat::communicationPolicy::ContextID<CommunicationPolicy>;
+                using VAddr               = typename graybat::communicationPolicy::VAddr<CommunicationPolicy>;
+                using Tag                 = typename graybat::communicationPolicy::Tag<CommunicationPolicy>;
+                using MsgType             = typename graybat::communicationPolicy::MsgType<CommunicationPolicy>;
+                using MsgID               = typename graybat::communicationPolicy::MsgID<CommunicationPolicy>;
+                using Release             = void (void *, void *);
+
+                static constexpr size_t headerSize = sizeof(MsgType) +
+                                                     sizeof(MsgID) +
+                                                     sizeof(ContextID) +
+                                                     sizeof(VAddr) +
+                                                     sizeof(Tag);
+
+                // Members
+                std::vector<std::int8_t> message;
+                std::int8_t const * payload;
+                size_t payloadSize;
+                size_t pendingSize;
+
+                // Methods
+                Message() :
+                    payload(nullptr),
+                    payloadSize(0),
+                    pendingSize(0){
+
+                }
+
+                template <typename T_Data>
+                Message(MsgType const msgType,
+                        MsgID const msgID,
+                        ContextID const contextID,
+                        VAddr const srcVAddr,
+                        Tag const tag,
+                        T_Data & data,
+                        Release * = nullptr,
+                        void * = nullptr) : message(headerSize),
+                                         payload(reinterpret_cast<std::int8_t const*>(data.data())),
+                                         payloadSize(data.size() * sizeof(typename T_Data::value_type)),
+                                         pendingSize(0){
+
+                    writeHeader(msgType, msgID, contextID, srcVAddr, tag);
+
+                }
+
+                template <typename T_Value>
+                Message(MsgType const msgType,
+                        MsgID const msgID,
+                        ContextID const contextID,
+                        VAddr const srcVAddr,
+                        Tag const tag,
+                        std::vector<T_Value> && data,
+                        Release * = nullptr,
+                        void * = nullptr) : Message(msgType, msgID, contextID, srcVAddr, tag, data){
+
+                }
+
+                /**
+                 * @brief Creates a message that owns an uninitialized payload
+                 *        of *size* bytes, which is filled through getData().
+                 */
+                static Message allocate(MsgType const msgType,
+                                        MsgID const msgID,
+                                        ContextID const contextID,
+                                        VAddr const srcVAddr,
+                                        Tag const tag,
+                                        size_t const size){
+                    Message message;
+                    message.message.resize(headerSize + size);
+                    message.writeHeader(msgType, msgID, contextID, srcVAddr, tag);
+                    return message;
+
+                }
+
+                MsgType getMsgType(){
+                    MsgType msgType;
+                    memcpy (&msgType, message.data(), sizeof(MsgType));
+                    return msgType;
+
+                }
+
+                MsgID getMsgID(){
+                    MsgID   msgID;
+                    memcpy (&msgID, message.data() + sizeof(MsgType), sizeof(MsgID));
+                    return msgID;
+
+                }
+
+                ContextID getContextID(){
+                    ContextID contextID;
+                    memcpy (&contextID, message.data() + sizeof(MsgType) + sizeof(MsgID), sizeof(ContextID));
+                    return contextID;
+
+                }
+
+                VAddr getVAddr(){
+                    VAddr vAddr;
+                    memcpy (&vAddr, message.data() + sizeof(MsgType) + sizeof(MsgID) + sizeof(ContextID), sizeof(VAddr));
+                    return vAddr;
+
+                }
+
+                Tag getTag(){
+                    Tag tag;
+                    memcpy (&tag, message.data() + sizeof(MsgType) + sizeof(MsgID) + sizeof(ContextID) + sizeof(VAddr), sizeof(Tag));
+                    return tag;
+
+                }
+
+		size_t size() {
+		    return message.size() + payloadSize;
+		}
+
+                std::int8_t* getData(){
+                    return message.data() + headerSize;
+
+                }
+
+                std::vector<std::int8_t>& getMessage(){
+                    return message;
+                }
+
+            private:
+                void writeHeader(MsgType const msgType, MsgID const msgID, ContextID const contextID, VAddr const srcVAddr, Tag const tag){
+                    size_t    msgOffset(0);
+                    memcpy (message.data() + msgOffset, &msgType,    sizeof(MsgType));   msgOffset += sizeof(MsgType);
+                    memcpy (message.data() + msgOffset, &msgID,      sizeof(MsgID));     msgOffset += sizeof(MsgID);
+                    memcpy (message.data() + msgOffset, &contextID,  sizeof(ContextID)); msgOffset += sizeof(ContextID);
+                    memcpy (message.data() + msgOffset, &srcVAddr,   sizeof(VAddr));     msgOffset += sizeof(VAddr);
+                    memcpy (message.data() + msgOffset, &tag,        sizeof(Tag));
+
+                }
+
+            };
+
+
+        } // shm
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
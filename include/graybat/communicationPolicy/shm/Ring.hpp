@@ -0,0 +1,289 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <algorithm> /* std::min */
+#include <cstdint>   /* std::uint64_t, std::int8_t */
+#include <cstring>   /* memcpy */
+#include <new>       /* placement new */
+#include <string>    /* std::string */
+#include <vector>    /* std::vector */
+
+// BOOST
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace shm {
+
+            /**
+             * @brief Byte ring buffer in a named shared memory segment.
+             *
+             * The ring is created by the receiving peer and opened by
+             * every peer that wants to send to it. Records are written
+             * as a length prefix followed by the record bytes. Several
+             * writers are serialized record by record, while one reader
+             * and one writer copy concurrently into disjoint parts of the
+             * ring. Records larger than the ring are streamed through it.
+             *
+             */
+            class Ring {
+
+                using Mutex     = boost::interprocess::interprocess_mutex;
+                using Condition = boost::interprocess::interprocess_condition;
+                using Lock      = boost::interprocess::scoped_lock<Mutex>;
+
+                struct Header {
+                    Mutex         mutex;
+                    Mutex         writerMutex;
+                    Condition     notEmpty;
+                    Condition     notFull;
+                    std::uint64_t capacity;
+                    std::uint64_t head;
+                    std::uint64_t tail;
+                };
+
+            public:
+                Ring() :
+                    owner(false),
+                    header(nullptr),
+                    buffer(nullptr){
+
+                }
+
+                Ring(Ring &&other) :
+                    name(std::move(other.name)),
+                    owner(other.owner),
+                    region(std::move(other.region)),
+                    header(other.header),
+                    buffer(other.buffer){
+                    other.owner  = false;
+                    other.header = nullptr;
+                    other.buffer = nullptr;
+                }
+
+                Ring& operator=(Ring &&other) {
+                    std::swap(name, other.name);
+                    std::swap(owner, other.owner);
+                    region.swap(other.region);
+                    std::swap(header, other.header);
+                    std::swap(buffer, other.buffer);
+                    return *this;
+                }
+
+                Ring(Ring &) = delete;
+                Ring& operator=(Ring &) = delete;
+
+                ~Ring(){
+                    if(owner){
+                        boost::interprocess::shared_memory_object::remove(name.c_str());
+                    }
+                }
+
+                /**
+                 * @brief Creates the segment *name* with a ring of *capacity* bytes.
+                 *        Throws boost::interprocess::interprocess_exception when
+                 *        a segment with this name already exists.
+                 */
+                void create(std::string const newName, std::size_t const capacity){
+                    using namespace boost::interprocess;
+                    shared_memory_object segment(create_only, newName.c_str(), read_write);
+                    name  = newName;
+                    owner = true;
+                    segment.truncate(sizeof(Header) + capacity);
+                    mapped_region(segment, read_write).swap(region);
+
+                    header   = new (region.get_address()) Header();
+                    header->capacity = capacity;
+                    header->head     = 0;
+                    header->tail     = 0;
+                    buffer = static_cast<std::int8_t*>(region.get_address()) + sizeof(Header);
+
+                }
+
+                /**
+                 * @brief Maps the already existing segment *name*.
+                 */
+                void open(std::string const existingName){
+                    using namespace boost::interprocess;
+                    shared_memory_object segment(open_only, existingName.c_str(), read_write);
+                    name  = existingName;
+                    owner = false;
+                    mapped_region(segment, read_write).swap(region);
+
+                    header = static_cast<Header*>(region.get_address());
+                    buffer = static_cast<std::int8_t*>(region.get_address()) + sizeof(Header);
+
+                }
+
+                /**
+                 * @brief Writes one record built of *head* and *body* bytes.
+                 */
+                void write(void const * head, std::size_t const headSize, void const * body, std::size_t const bodySize){
+                    Lock writerLock(header->writerMutex);
+                    std::uint64_t const size = headSize + bodySize;
+                    writeBytes(&size, sizeof(size));
+                    writeBytes(head, headSize);
+                    writeBytes(body, bodySize);
+
+                }
+
+                /**
+                 * @brief Blocks until a record is available and reads it into *record*.
+                 *
+                 * @remark Only one thread may read from a ring.
+                 */
+                void read(std::vector<std::int8_t> &record){
+                    std::uint64_t const size = readSize();
+                    record.resize(size);
+                    readBytes(record.data(), size);
+
+                }
+
+                /**
+                 * @brief Blocks until a record is available and returns its
+                 *        size. The record bytes have to be consumed by
+                 *        readInto and skip afterwards.
+                 */
+                std::uint64_t readSize(){
+                    std::uint64_t size = 0;
+                    readBytes(&size, sizeof(size));
+                    return size;
+
+                }
+
+                /**
+                 * @brief Reads the next *size* bytes of the current record into *data*.
+                 */
+                void readInto(void * data, std::size_t const size){
+                    readBytes(data, size);
+
+                }
+
+                /**
+                 * @brief Discards the next *size* bytes of the current record.
+                 */
+                void skip(std::size_t const size){
+                    readBytes(nullptr, size);
+
+                }
+
+                std::string const& getName() const {
+                    return name;
+                }
+
+            private:
+                std::string name;
+                bool owner;
+                boost::interprocess::mapped_region region;
+                Header* header;
+                std::int8_t* buffer;
+
+                void writeBytes(void const * data, std::size_t const size){
+                    std::int8_t const * src = static_cast<std::int8_t const*>(data);
+                    std::size_t written = 0;
+
+                    while(written < size){
+                        std::uint64_t tail  = 0;
+                        std::uint64_t space = 0;
+                        {
+                            Lock lock(header->mutex);
+                            while(header->tail - header->head == header->capacity){
+                                header->notFull.wait(lock);
+                            }
+                            tail  = header->tail;
+                            space = header->capacity - (header->tail - header->head);
+                        }
+
+                        // Region [tail, tail + n) is not touched by the reader
+                        std::size_t const n = std::min<std::size_t>(space, size - written);
+                        copyIn(tail, src + written, n);
+                        written += n;
+
+                        {
+                            Lock lock(header->mutex);
+                            header->tail += n;
+                        }
+                        header->notEmpty.notify_one();
+                    }
+
+                }
+
+                void readBytes(void * data, std::size_t const size){
+                    std::int8_t * dest = static_cast<std::int8_t*>(data);
+                    std::size_t read = 0;
+
+                    while(read < size){
+                        std::uint64_t head      = 0;
+                        std::uint64_t available = 0;
+                        {
+                            Lock lock(header->mutex);
+                            while(header->tail == header->head){
+                                header->notEmpty.wait(lock);
+                            }
+                            head      = header->head;
+                            available = header->tail - header->head;
+                        }
+
+                        // Region [head, head + n) is not touched by any writer
+                        std::size_t const n = std::min<std::size_t>(available, size - read);
+                        if(dest != nullptr){
+                            copyOut(head, dest + read, n);
+                        }
+                        read += n;
+
+                        {
+                            Lock lock(header->mutex);
+                            header->head += n;
+                        }
+                        header->notFull.notify_one();
+                    }
+
+                }
+
+                void copyIn(std::uint64_t const pos, std::int8_t const * src, std::size_t const size){
+                    std::size_t const offset = pos % header->capacity;
+                    std::size_t const first  = std::min<std::size_t>(size, header->capacity - offset);
+                    memcpy(buffer + offset, src, first);
+                    memcpy(buffer, src + first, size - first);
+                }
+
+                void copyOut(std::uint64_t const pos, std::int8_t * dest, std::size_t const size){
+                    std::size_t const offset = pos % header->capacity;
+                    std::size_t const first  = std::min<std::size_t>(size, header->capacity - offset);
+                    memcpy(dest, buffer + offset, first);
+                    memcpy(dest + first, buffer, size - first);
+                }
+
+            };
+
+        } // shm
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
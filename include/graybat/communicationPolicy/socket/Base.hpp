@@ -25,8 +25,18 @@
 #include <mutex>  /* std::mutex */
 #include <map>    /* std::map */
 #include <vector> /* std::vector */
+#include <deque>  /* std::deque */
+#include <memory> /* std::shared_ptr */
+#include <tuple>  /* std::tuple */
 #include <thread> /* std::thread */
+#include <atomic> /* std::atomic */
+#include <condition_variable> /* std::condition_variable */
 #include <exception> /* std::runtime_error */
+#include <utility> /* std::forward, std::move */
+#include <algorithm> /* std::min */
+#include <array>  /* std::array */
+#include <type_traits> /* std::decay, std::is_lvalue_reference */
+#include <chrono> /* std::chrono::steady_clock */
 
 // BOOST
 #include <boost/optional.hpp>
@@ -36,7 +46,11 @@
 #include <graybat/communicationPolicy/Base.hpp>          /* graybat::communicationPolicy::Base */
 #include <graybat/communicationPolicy/Traits.hpp>        /* cp related types */
 #include <graybat/communicationPolicy/socket/Traits.hpp> /* socket related types */
+#include <graybat/communicationPolicy/socket/PostedRecv.hpp> /* PostedRecv */
+#include <graybat/communicationPolicy/socket/CompletionTable.hpp> /* CompletionTable */
+#include <graybat/communicationPolicy/socket/Wait.hpp>   /* WaitStrategy */
 #include <graybat/utils/MultiKeyMap.hpp>                 /* utils::MessageBox */
+#include <graybat/utils/Members.hpp>                     /* utils::IsRawBytes */
 
 namespace graybat {
 
@@ -66,11 +80,76 @@ namespace graybat {
                 const Uri masterUri;
                 const size_t contextSize;
                 const ContextName contextName;
-                unsigned maxMsgID;
-                std::mutex sendMtx;
+                std::atomic<unsigned> maxMsgID;
+                bool zeroCopy;
+                const WaitStrategy waitStrategy;
+
+                // Sends to one peer socket are serialized by its lane,
+                // sends to different peers proceed in parallel
+                struct SendLane {
+                    std::mutex data;
+                    std::mutex ctrl;
+
+                    // Small peer messages waiting to be sent as one frame
+                    std::vector<std::int8_t> batch;
+                    size_t records = 0;
+                    std::chrono::steady_clock::time_point deadline;
+                    std::chrono::microseconds delay;
+                };
+                std::unique_ptr<SendLane[]> sendLanes;
                 std::map<ContextID, std::map<VAddr, std::size_t> > sendSocketMappings;
                 utils::MessageBox<Message, MsgType, ContextID, VAddr, Tag> inBox;
-                utils::MessageBox<Message, MsgType, ContextID, VAddr, Tag> ctrlBox;
+
+                // Sends whose buffer is still used by the transport
+                CompletionTable<MsgID> completions;
+
+                // Flow control, credits and received messages per peer socket
+                const size_t creditWindow;
+                std::mutex creditMtx;
+                std::condition_variable creditCondition;
+                std::vector<size_t> sendCredits;
+                std::vector<size_t> recvCounts;
+
+                // Receives posted before their message arrived
+                std::mutex postMtx;
+                std::map<std::tuple<MsgType, ContextID, VAddr, Tag>, std::deque<std::shared_ptr<PostedRecv> > > postedRecvs;
+
+                // Peer messages above chunkSize bytes are sent in chunks
+                const size_t chunkSize;
+
+                // Bytes of a large message that are sent as one chunk
+                struct Chunk {
+                    using value_type = std::int8_t;
+                    std::int8_t const * begin;
+                    size_t length;
+
+                    std::int8_t const * data() const { return begin; }
+                    size_t size() const { return length; }
+                };
+
+                // Chunked message that is received by the receive handler,
+                // either into a posted receive or into a message of its own
+                struct Transfer {
+                    Tag tag;
+                    std::shared_ptr<PostedRecv> posted;
+                    Message message;
+                    std::int8_t * data;
+                    size_t capacity;
+                    size_t total;
+                    size_t chunkSize;
+                    size_t offset;
+                };
+                std::map<std::tuple<ContextID, VAddr, MsgID>, Transfer> transfers;
+
+                // Coalescing of small peer messages, the flush handler sends
+                // frames whose deadline passed
+                const size_t coalesceSize;
+                const size_t coalesceThreshold;
+                const std::chrono::microseconds coalesceDelay;
+                std::mutex flushMtx;
+                std::condition_variable flushCondition;
+                bool flushWakeup;
+                bool flushStop;
 
 
                 std::map<ContextID, Context> contexts;
@@ -84,6 +163,7 @@ namespace graybat {
 
                 std::thread recvHandler;
                 std::thread ctrlHandler;
+                std::thread flushHandler;
 
                 // Constructor
                 Base(Config const config);
@@ -118,6 +198,15 @@ namespace graybat {
                 template <typename T_Socket>
                 void recvFromSocket (T_Socket& socket, Message & message) = delete;
 
+                template <typename T_Socket>
+                void recvHeaderFromSocket (T_Socket& socket, Message & message) = delete;
+
+                template <typename T_Socket>
+                void recvPayloadFromSocket (T_Socket& socket, Message & message) = delete;
+
+                template <typename T_Socket>
+                void recvPayloadFromSocket (T_Socket& socket, Message & message, std::int8_t * data, size_t const size) = delete;
+
                 void createSocketsToPeers() = delete;
 
                 // P2P INTERFACE
@@ -154,6 +243,14 @@ namespace graybat {
                 template <typename T_Send>
                 Event asyncSend(const VAddr destVAddr, const Tag tag, const Context context, const T_Send& sendData);
 
+                /**
+                 * @brief Non blocking transmission of the moved in *sendData*. The
+                 *        message takes over the buffer of *sendData*, thus it is
+                 *        not copied before it is transmitted.
+                 */
+                template <typename T_Value>
+                Event asyncSend(const VAddr destVAddr, const Tag tag, const Context context, std::vector<T_Value>&& sendData);
+
                 /**
                  * @brief Blocking receive of a message recvData from peer with virtual address srcVAddr.
                  * 
@@ -172,11 +269,26 @@ namespace graybat {
                 template <typename T_Recv>
                 Event recv(const Context context, T_Recv& recvData);
 
+                /**
+                 * @brief Non blocking receive of a message recvData from peer with virtual address srcVAddr.
+                 *        When the message did not arrive yet, recvData is posted and the
+                 *        payload of the message is received straight into it. Thus,
+                 *        recvData has to stay valid until the returned event is finished.
+                 *
+                 * @return Event
+                 */
                 template <typename T_Recv>
                 Event asyncRecv(const VAddr srcVAddr, const Tag tag, const Context context, T_Recv& recvData);
 
                 // EVENT INTERFACE
                 bool ready(const MsgID msgID, const Context context, const VAddr vAddr, const Tag tag);
+                void wait(const MsgID msgID, const Context context, const VAddr vAddr, const Tag tag);
+
+                /**
+                 * @brief Sends all small messages that wait in coalescing
+                 *        frames without waiting for their deadline.
+                 */
+                void flush();
 
                 // CONTEXT INTERFACE
                 Context getGlobalContext();
@@ -198,8 +310,16 @@ namespace graybat {
 
 
                 // Auxilary
+                template <typename T_Value>
+                static void checkRawBytes();
+
                 template <typename T_Send>
-                void asyncSendImpl(MsgType const msgType, MsgID const msgID, Context const context,VAddr const destVAddr, Tag const tag, T_Send & sendData);
+                void asyncSendImpl(MsgType const msgType, MsgID const msgID, Context const context,VAddr const destVAddr, Tag const tag, T_Send && sendData);
+
+                void sendChunked(MsgID const msgID, Context const context, VAddr const destVAddr, Tag const tag, std::int8_t const * data, size_t const size, bool const track);
+
+                void coalesce(std::size_t const sendSocket_i, MsgID const msgID, Context const context, Tag const tag, std::int8_t const * data, size_t const size);
+                void flushLane(std::size_t const sendSocket_i);
 
                 template <typename T_Recv>
                 void recvImpl(MsgType const msgType, Context const context,VAddr const destVAddr, Tag const tag, T_Recv & recvData);
@@ -208,16 +328,24 @@ namespace graybat {
                 Event recvImpl(Context const context, T_Recv & recvData);
 
                 template <typename T_Recv>
-                bool asyncRecvImpl(MsgType const msgType, Context const context,VAddr const destVAddr, Tag const tag, T_Recv & recvData);
+                std::shared_ptr<PostedRecv> asyncRecvImpl(MsgType const msgType, Context const context,VAddr const destVAddr, Tag const tag, T_Recv & recvData);
 
-                template <typename T_Recv>
-                bool asyncRecvImpl(MsgType const msgType, Context const context,VAddr const destVAddr, Tag const tag, T_Recv * recvData, size_t const size);
+                std::shared_ptr<PostedRecv> asyncRecvImpl(MsgType const msgType, Context const context,VAddr const destVAddr, Tag const tag, std::int8_t * recvData, size_t const size);
 
 
                 MsgID getMsgID();
 
+                void acquireCredit(std::size_t const sendSocket_i);
+                void grantCredit(ContextID const contextID, VAddr const srcVAddr);
+
+                std::shared_ptr<PostedRecv> popPosted(std::tuple<MsgType, ContextID, VAddr, Tag> const &key);
+                void deliver(std::tuple<MsgType, ContextID, VAddr, Tag> const &key, Message &message);
+                void recvChunk(Message &message);
+                void recvBatch(Message &message);
+
                 void handleRecv();
                 void handleCtrl();
+                void handleFlush();
 
             };
 
@@ -228,8 +356,16 @@ namespace graybat {
                     contextSize(config.contextSize),
                     contextName(config.contextName),
                     maxMsgID(0),
+                    zeroCopy(false),
+                    waitStrategy(config.waitStrategy),
                     inBox(config.maxBufferSize),
-                    ctrlBox(config.maxBufferSize){
+                    creditWindow(std::max<size_t>(config.credits, 1)),
+                    chunkSize(std::max<size_t>(config.chunkSize, 1)),
+                    coalesceSize(config.coalesceSize),
+                    coalesceThreshold(std::min(config.coalesceThreshold, config.coalesceSize)),
+                    coalesceDelay(std::max<size_t>(config.coalesceDelay, 1)),
+                    flushWakeup(false),
+                    flushStop(false){
 
             }
 
@@ -269,6 +405,12 @@ namespace graybat {
                 // Create socket connection to other peers
                 // Create socketmapping from initial context to sockets of VAddrs
                 static_cast<CommunicationPolicy*>(this)->createSocketsToPeers();
+                sendLanes.reset(new SendLane[static_cast<CommunicationPolicy*>(this)->sendSockets.size()]);
+                sendCredits.assign(static_cast<CommunicationPolicy*>(this)->sendSockets.size(), creditWindow);
+                recvCounts.assign(static_cast<CommunicationPolicy*>(this)->sendSockets.size(), 0);
+                for(std::size_t socket_i = 0; socket_i < static_cast<CommunicationPolicy*>(this)->sendSockets.size(); ++socket_i){
+                    sendLanes[socket_i].delay = coalesceDelay;
+                }
 
                 for(auto const &vAddr : initialContext){                    
                     sendSocketMappings[initialContext.getID()][vAddr] = vAddr;
@@ -282,6 +424,9 @@ namespace graybat {
                 // Create thread which recv all messages to this peer
                 recvHandler = std::thread(&Base<CommunicationPolicy>::handleRecv, this);
                 ctrlHandler = std::thread(&Base<CommunicationPolicy>::handleCtrl, this);
+                if(coalesceSize > 0){
+                    flushHandler = std::thread(&Base<CommunicationPolicy>::handleFlush, this);
+                }
 
             }
 
@@ -292,6 +437,16 @@ namespace graybat {
                 ss << static_cast<size_t>(MsgType::DESTRUCT) << " " << contextName;
                 static_cast<CommunicationPolicy*>(this)->sendToSocket(static_cast<CommunicationPolicy*>(this)->signalingSocket, ss);
 
+                if(flushHandler.joinable()){
+                    {
+                        std::lock_guard<std::mutex> lock(flushMtx);
+                        flushStop = true;
+                    }
+                    flushCondition.notify_one();
+                    flushHandler.join();
+                }
+                flush();
+
                 std::array<unsigned, 1>  null;
                 static_cast<CommunicationPolicy*>(this)->asyncSendImpl(MsgType::DESTRUCT, 0, initialContext, initialContext.getVAddr(), 0, null);
                 recvHandler.join();
@@ -299,6 +454,17 @@ namespace graybat {
 
             }
 
+            /**
+             * @brief Rejects element types whose bytes can not be
+             *        transmitted as they are.
+             */
+            template <typename T_CommunicationPolicy>
+            template <typename T_Value>
+            void Base<T_CommunicationPolicy>::checkRawBytes(){
+                static_assert(::utils::IsRawBytes<T_Value>::value,
+                              "Socket policies transmit the bytes of the elements, which need to be trivially copyable or Hana adapted.");
+            }
+
             template <typename T_CommunicationPolicy>
             template <typename T_Send>
             auto Base<T_CommunicationPolicy>::send(const graybat::communicationPolicy::VAddr<T_CommunicationPolicy> destVAddr,
@@ -322,6 +488,8 @@ namespace graybat {
                                                         const T_Send& sendData)
             -> graybat::communicationPolicy::Event<T_CommunicationPolicy>
             {
+                checkRawBytes<typename T_Send::value_type>();
+
                 using CommunicationPolicy = T_CommunicationPolicy;
                 using MsgType             = graybat::communicationPolicy::MsgType<CommunicationPolicy>;
                 using MsgID               = graybat::communicationPolicy::MsgID<CommunicationPolicy>;
@@ -335,6 +503,23 @@ namespace graybat {
 
             }
 
+            template <typename T_CommunicationPolicy>
+            template <typename T_Value>
+            auto Base<T_CommunicationPolicy>::asyncSend(const graybat::communicationPolicy::VAddr<T_CommunicationPolicy> destVAddr,
+                                                        const graybat::communicationPolicy::Tag<T_CommunicationPolicy> tag,
+                                                        const graybat::communicationPolicy::Context<T_CommunicationPolicy> context,
+                                                        std::vector<T_Value>&& sendData)
+            -> graybat::communicationPolicy::Event<T_CommunicationPolicy>
+            {
+                checkRawBytes<T_Value>();
+
+                MsgID msgID = getMsgID();
+                asyncSendImpl(MsgType::PEER, msgID, context, destVAddr, tag, std::move(sendData));
+
+                return Event(msgID, context, destVAddr, tag, *static_cast<CommunicationPolicy*>(this));
+
+            }
+
             template <typename T_CommunicationPolicy>
             template <typename T_Recv>
             auto Base<T_CommunicationPolicy>::recv(const graybat::communicationPolicy::VAddr<T_CommunicationPolicy> srcVAddr,
@@ -343,6 +528,8 @@ namespace graybat {
                                                    T_Recv& recvData)
             -> void
             {
+                checkRawBytes<typename T_Recv::value_type>();
+
                 using CommunicationPolicy = T_CommunicationPolicy;
                 using MsgType             = graybat::communicationPolicy::MsgType<CommunicationPolicy>;
 
@@ -358,6 +545,8 @@ namespace graybat {
                                                    T_Recv& recvData)
             -> graybat::communicationPolicy::Event<T_CommunicationPolicy>
             {
+                checkRawBytes<typename T_Recv::value_type>();
+
                 return recvImpl(context, recvData);
             }
 
@@ -370,37 +559,50 @@ namespace graybat {
                                                         T_Recv& recvData)
             -> graybat::communicationPolicy::Event<T_CommunicationPolicy>
             {
-                bool result = asyncRecvImpl(MsgType::PEER, context, srcVAddr, tag, recvData);
-                //std::cout << "Size before event creation: " << sizeof(typename T_Recv::value_type) * recvData.size() << std::endl;
-                return Event(getMsgID(), context, srcVAddr, tag, recvData, result, *(static_cast<CommunicationPolicy*>(this)));
+                checkRawBytes<typename T_Recv::value_type>();
+
+                std::shared_ptr<PostedRecv> posted = asyncRecvImpl(MsgType::PEER, context, srcVAddr, tag, recvData);
+                return Event(getMsgID(), context, srcVAddr, tag, posted, *(static_cast<CommunicationPolicy*>(this)));
             }
 
+            /**
+             * @brief A send is ready as soon as its buffer can be reused,
+             *        the receiver does not need to be involved.
+             */
             template <typename T_CommunicationPolicy>
             auto Base<T_CommunicationPolicy>::ready(const graybat::communicationPolicy::MsgID<T_CommunicationPolicy> msgID,
-                                                    const graybat::communicationPolicy::Context<T_CommunicationPolicy> context,
-                                                    const graybat::communicationPolicy::VAddr<T_CommunicationPolicy> vAddr,
-                                                    const graybat::communicationPolicy::Tag<T_CommunicationPolicy> tag)
+                                                    const graybat::communicationPolicy::Context<T_CommunicationPolicy>,
+                                                    const graybat::communicationPolicy::VAddr<T_CommunicationPolicy>,
+                                                    const graybat::communicationPolicy::Tag<T_CommunicationPolicy>)
             -> bool
             {
-                using CommunicationPolicy = T_CommunicationPolicy;
-                using Message             = graybat::communicationPolicy::socket::Message<CommunicationPolicy>;
-                using MsgType             = graybat::communicationPolicy::MsgType<CommunicationPolicy>;
+                return completions.test(msgID);
 
-                Message message(std::move(ctrlBox.waitDequeue(MsgType::CONFIRM, context.getID(), vAddr, tag)));
+            }
 
-                // size_t    msgOffset = 0;
-                // MsgType   remoteMsgType;
-                // MsgID     remoteMsgID;
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::wait(const graybat::communicationPolicy::MsgID<T_CommunicationPolicy> msgID,
+                                                   const graybat::communicationPolicy::Context<T_CommunicationPolicy>,
+                                                   const graybat::communicationPolicy::VAddr<T_CommunicationPolicy>,
+                                                   const graybat::communicationPolicy::Tag<T_CommunicationPolicy>)
+            -> void
+            {
+                completions.wait(msgID);
 
+            }
 
-                if(message.getMsgID() == msgID){
-                    return true;
-                }
-                else {
-                    ctrlBox.enqueue(std::move(message), MsgType::CONFIRM, context.getID(), vAddr, tag);
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::flush()
+            -> void
+            {
+                if(coalesceSize == 0){
+                    return;
                 }
 
-                return false;
+                for(std::size_t socket_i = 0; socket_i < static_cast<CommunicationPolicy*>(this)->sendSockets.size(); ++socket_i){
+                    std::lock_guard<std::mutex> dataLock(sendLanes[socket_i].data);
+                    flushLane(socket_i);
+                }
 
             }
 
@@ -634,38 +836,199 @@ namespace graybat {
                                                             graybat::communicationPolicy::Context<T_CommunicationPolicy> const context,
                                                             graybat::communicationPolicy::VAddr<T_CommunicationPolicy> const destVAddr,
                                                             graybat::communicationPolicy::Tag<T_CommunicationPolicy> const tag,
-                                                            T_Send & sendData)
+                                                            T_Send && sendData)
             -> void {
 
                 using Message   = graybat::communicationPolicy::socket::Message<T_CommunicationPolicy>;
 
+                using Data      = typename std::decay<T_Send>::type;
+
                 //std::cout << "send msg: " << static_cast<int>(msgType) << " " << msgID << " " << context.getID() << " " << destVAddr << "(socket_i " <<  sendSocketMappings.at(context.getID()).at(destVAddr)<< ") " << tag << std::endl;
 
-                // Create message
-                Message message(msgType, msgID, context.getID(), context.getVAddr(), tag, sendData);
+                size_t const size = sendData.size() * sizeof(typename Data::value_type);
+                if(msgType == MsgType::PEER && size > chunkSize){
+                    // A moved in buffer lives only until this call returns,
+                    // thus its chunks are always copied
+                    sendChunked(msgID, context, destVAddr, tag, reinterpret_cast<std::int8_t const*>(sendData.data()), size,
+                                zeroCopy && std::is_lvalue_reference<T_Send>::value);
+                    return;
+                }
 
                 std::size_t sendSocket_i  = sendSocketMappings.at(context.getID()).at(destVAddr);
                 Socket &sendSocket = static_cast<CommunicationPolicy*>(this)->sendSockets.at(sendSocket_i);
                 Socket &ctrlSendSocket = static_cast<CommunicationPolicy*>(this)->ctrlSendSockets.at(sendSocket_i);
 
+                if(msgType == MsgType::PEER && size <= coalesceThreshold && coalesceSize > 0){
+                    coalesce(sendSocket_i, msgID, context, tag, reinterpret_cast<std::int8_t const*>(sendData.data()), size);
+                    return;
+                }
+
+                if(msgType == MsgType::PEER){
+                    acquireCredit(sendSocket_i);
+                }
 
-                sendMtx.lock();
-                if(msgType == MsgType::CONFIRM){
-                    static_cast<CommunicationPolicy*>(this)->sendToSocket(ctrlSendSocket, message.getMessage());
+                // Create message, only peer messages may be send from the buffer of the caller.
+                // Such a send stays pending until the transport releases the buffer.
+                bool const track = zeroCopy && msgType == MsgType::PEER;
+                Message message(msgType, msgID, context.getID(), context.getVAddr(), tag, std::forward<T_Send>(sendData),
+                                track ? &CompletionTable<MsgID>::release : nullptr,
+                                track ? completions.add(msgID) : nullptr);
+
+                SendLane &lane = sendLanes[sendSocket_i];
+                if(msgType == MsgType::CREDIT){
+                    std::lock_guard<std::mutex> ctrlLock(lane.ctrl);
+                    static_cast<CommunicationPolicy*>(this)->sendToSocket(ctrlSendSocket, message);
                 }
                 else {
 
                     if(msgType == MsgType::DESTRUCT){
                         Message message2(msgType, msgID, context.getID(), context.getVAddr(), tag, sendData);
-                        static_cast<CommunicationPolicy*>(this)->sendToSocket(sendSocket, message.getMessage());
-                        static_cast<CommunicationPolicy*>(this)->sendToSocket(ctrlSendSocket, message2.getMessage());
+                        std::lock(lane.data, lane.ctrl);
+                        std::lock_guard<std::mutex> dataLock(lane.data, std::adopt_lock);
+                        std::lock_guard<std::mutex> ctrlLock(lane.ctrl, std::adopt_lock);
+                        flushLane(sendSocket_i);
+                        static_cast<CommunicationPolicy*>(this)->sendToSocket(sendSocket, message);
+                        static_cast<CommunicationPolicy*>(this)->sendToSocket(ctrlSendSocket, message2);
 
                     }
                     else {
-                        static_cast<CommunicationPolicy*>(this)->sendToSocket(sendSocket, message.getMessage());
+                        // Coalesced messages are sent first to keep the order
+                        std::lock_guard<std::mutex> dataLock(lane.data);
+                        flushLane(sendSocket_i);
+                        static_cast<CommunicationPolicy*>(this)->sendToSocket(sendSocket, message);
                     }
                 }
-                sendMtx.unlock();
+
+            }
+
+            /**
+             * @brief Sends *size* bytes of *data* as an announcement that
+             *        carries the total size and the chunk size, followed by
+             *        the chunks. All of them share *msgID* and each of them
+             *        takes one credit, thus the receiver consumes the first
+             *        chunks while the following ones are still in flight.
+             */
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::sendChunked(graybat::communicationPolicy::MsgID<T_CommunicationPolicy> const msgID,
+                                                          graybat::communicationPolicy::Context<T_CommunicationPolicy> const context,
+                                                          graybat::communicationPolicy::VAddr<T_CommunicationPolicy> const destVAddr,
+                                                          graybat::communicationPolicy::Tag<T_CommunicationPolicy> const tag,
+                                                          std::int8_t const * data,
+                                                          size_t const size,
+                                                          bool const track)
+            -> void {
+
+                using Message   = graybat::communicationPolicy::socket::Message<T_CommunicationPolicy>;
+
+                std::size_t sendSocket_i  = sendSocketMappings.at(context.getID()).at(destVAddr);
+                Socket &sendSocket = static_cast<CommunicationPolicy*>(this)->sendSockets.at(sendSocket_i);
+                SendLane &lane = sendLanes[sendSocket_i];
+
+                std::array<std::uint64_t, 2> announce {{ size, chunkSize }};
+                acquireCredit(sendSocket_i);
+                {
+                    Message message(MsgType::CHUNK, msgID, context.getID(), context.getVAddr(), tag, announce);
+                    std::lock_guard<std::mutex> dataLock(lane.data);
+                    flushLane(sendSocket_i);
+                    static_cast<CommunicationPolicy*>(this)->sendToSocket(sendSocket, message);
+                }
+
+                for(size_t offset = 0; offset < size; offset += chunkSize){
+                    Chunk chunk {data + offset, std::min(chunkSize, size - offset)};
+                    acquireCredit(sendSocket_i);
+                    Message message(MsgType::CHUNK, msgID, context.getID(), context.getVAddr(), tag, chunk,
+                                    track ? &CompletionTable<MsgID>::release : nullptr,
+                                    track ? completions.add(msgID) : nullptr);
+                    std::lock_guard<std::mutex> dataLock(lane.data);
+                    static_cast<CommunicationPolicy*>(this)->sendToSocket(sendSocket, message);
+                }
+
+            }
+
+            /**
+             * @brief Appends a small peer message as record to the frame of
+             *        its destination socket. A record consists of msgID,
+             *        contextID, source vAddr, tag, payload size and payload.
+             *        The copy completes the send at once.
+             */
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::coalesce(std::size_t const sendSocket_i,
+                                                       graybat::communicationPolicy::MsgID<T_CommunicationPolicy> const msgID,
+                                                       graybat::communicationPolicy::Context<T_CommunicationPolicy> const context,
+                                                       graybat::communicationPolicy::Tag<T_CommunicationPolicy> const tag,
+                                                       std::int8_t const * data,
+                                                       size_t const size)
+            -> void {
+
+                ContextID const contextID = context.getID();
+                VAddr const srcVAddr      = context.getVAddr();
+                std::uint64_t const payloadSize = size;
+                size_t const recordSize = sizeof(MsgID) + sizeof(ContextID) + sizeof(VAddr) + sizeof(Tag) + sizeof(std::uint64_t) + size;
+
+                SendLane &lane = sendLanes[sendSocket_i];
+                bool started = false;
+                {
+                    std::lock_guard<std::mutex> dataLock(lane.data);
+
+                    // Full frame, traffic to this peer is dense enough to wait longer
+                    if(!lane.batch.empty() && lane.batch.size() + recordSize > coalesceSize){
+                        lane.delay = std::min(lane.delay * 2, coalesceDelay);
+                        flushLane(sendSocket_i);
+                    }
+
+                    if(lane.batch.empty()){
+                        lane.batch.reserve(coalesceSize);
+                        lane.deadline = std::chrono::steady_clock::now() + lane.delay;
+                        started = true;
+                    }
+
+                    size_t msgOffset = lane.batch.size();
+                    lane.batch.resize(msgOffset + recordSize);
+                    std::int8_t * record = lane.batch.data();
+                    memcpy (record + msgOffset, &msgID,       sizeof(MsgID));         msgOffset += sizeof(MsgID);
+                    memcpy (record + msgOffset, &contextID,   sizeof(ContextID));     msgOffset += sizeof(ContextID);
+                    memcpy (record + msgOffset, &srcVAddr,    sizeof(VAddr));         msgOffset += sizeof(VAddr);
+                    memcpy (record + msgOffset, &tag,         sizeof(Tag));           msgOffset += sizeof(Tag);
+                    memcpy (record + msgOffset, &payloadSize, sizeof(std::uint64_t)); msgOffset += sizeof(std::uint64_t);
+                    if(size > 0){
+                        memcpy (record + msgOffset, data, size);
+                    }
+                    lane.records++;
+                }
+
+                // The flush handler has to know the deadline of a new frame
+                if(started){
+                    {
+                        std::lock_guard<std::mutex> lock(flushMtx);
+                        flushWakeup = true;
+                    }
+                    flushCondition.notify_one();
+                }
+
+            }
+
+            /**
+             * @brief Sends the frame of *sendSocket_i* as one BATCH message,
+             *        which takes one credit.
+             *
+             * @remark The data lane of *sendSocket_i* has to be locked by the caller.
+             */
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::flushLane(std::size_t const sendSocket_i)
+            -> void {
+
+                using Message   = graybat::communicationPolicy::socket::Message<T_CommunicationPolicy>;
+
+                SendLane &lane = sendLanes[sendSocket_i];
+                if(lane.batch.empty()){
+                    return;
+                }
+
+                acquireCredit(sendSocket_i);
+                Message message(MsgType::BATCH, 0, initialContext.getID(), initialContext.getVAddr(), 0, std::move(lane.batch));
+                lane.batch.clear();
+                lane.records = 0;
+                static_cast<CommunicationPolicy*>(this)->sendToSocket(static_cast<CommunicationPolicy*>(this)->sendSockets.at(sendSocket_i), message);
 
             }
 
@@ -678,12 +1041,13 @@ namespace graybat {
                                                        T_Recv& recvData)
             -> void {
 
-                using Message   = graybat::communicationPolicy::socket::Message<T_CommunicationPolicy>;
-
-                Message message(std::move(inBox.waitDequeue(msgType, context.getID(), srcVAddr, tag)));
-                memcpy (static_cast<void*>(recvData.data()),
-                        static_cast<std::int8_t*>(message.getData()),
-                        sizeof(typename T_Recv::value_type) * recvData.size());
+                std::shared_ptr<PostedRecv> posted = asyncRecvImpl(msgType, context, srcVAddr, tag, recvData);
+                if(posted){
+                    flush();
+                    waitFor(waitStrategy,
+                            [&posted]{ return posted->test(); },
+                            [&posted]{ posted->wait(); });
+                }
 
             }
 
@@ -702,6 +1066,7 @@ namespace graybat {
                 VAddr destVAddr;
                 Tag tag;
 
+                flush();
                 Message message(std::move(inBox.waitDequeue(keys, MsgType::PEER, context.getID())));
                 destVAddr = std::get<2>(keys);
                 tag = std::get<3>(keys);
@@ -710,7 +1075,7 @@ namespace graybat {
                         static_cast<std::int8_t*>(message.getData()),
                         sizeof(typename T_Recv::value_type) * recvData.size());
 
-                return Event(getMsgID(), context, destVAddr, tag, *(static_cast<CommunicationPolicy*>(this)));
+                return Event(getMsgID(), context, destVAddr, tag, nullptr, *(static_cast<CommunicationPolicy*>(this)));
 
             }
 
@@ -722,44 +1087,53 @@ namespace graybat {
                                                             graybat::communicationPolicy::VAddr<T_CommunicationPolicy> const srcVAddr,
                                                             graybat::communicationPolicy::Tag<T_CommunicationPolicy> const tag,
                                                             T_Recv& recvData)
-            -> bool {
+            -> std::shared_ptr<PostedRecv> {
+
+                return asyncRecvImpl(msgType, context, srcVAddr, tag,
+                                     reinterpret_cast<std::int8_t*>(recvData.data()),
+                                     sizeof(typename T_Recv::value_type) * recvData.size());
 
-                using Message = graybat::communicationPolicy::socket::Message<T_CommunicationPolicy>;
-                bool result = false;
-                Message message = std::move(inBox.tryDequeue(result, msgType, context.getID(), srcVAddr, tag));
-                if(result) {
-                    memcpy (static_cast<void*>(recvData.data()),
-                            static_cast<std::int8_t*>(message.getData()),
-                            sizeof(typename T_Recv::value_type) * recvData.size());
-                    return true;
-                }
-                return false;
             }
 
+            /**
+             * @brief Copies an already received message into *recvData* or
+             *        posts *recvData* for the receive handler. Returns the
+             *        posted receive or nullptr when the data was copied.
+             */
             template <typename T_CommunicationPolicy>
-            template <typename T_Recv>
             auto Base<T_CommunicationPolicy>::asyncRecvImpl(graybat::communicationPolicy::MsgType<T_CommunicationPolicy> const msgType,
                                                             graybat::communicationPolicy::Context<T_CommunicationPolicy> const context,
                                                             graybat::communicationPolicy::VAddr<T_CommunicationPolicy> const srcVAddr,
                                                             graybat::communicationPolicy::Tag<T_CommunicationPolicy> const tag,
-                                                            T_Recv * recvData,
+                                                            std::int8_t * recvData,
                                                             size_t const size)
-            -> bool {
+            -> std::shared_ptr<PostedRecv> {
 
                 using Message = graybat::communicationPolicy::socket::Message<T_CommunicationPolicy>;
+
                 bool result = false;
                 Message message = std::move(inBox.tryDequeue(result, msgType, context.getID(), srcVAddr, tag));
-                if(result) {
-                    //std::cout << "Copy data: " << "bytes: " << size << " " << "0: " << reinterpret_cast<unsigned*>(message.getData())[0] << " 1: " << reinterpret_cast<unsigned*>(message.getData())[1]<< std::endl;
-                     memcpy (recvData,
-                             static_cast<std::int8_t*>(message.getData()),
-                             size);
-                    return true;
+
+                std::shared_ptr<PostedRecv> posted;
+                if(!result){
+                    // The receive handler enqueues under postMtx, thus a message
+                    // is either found here or will find the posted receive
+                    std::lock_guard<std::mutex> lock(postMtx);
+                    message = std::move(inBox.tryDequeue(result, msgType, context.getID(), srcVAddr, tag));
+                    if(!result){
+                        posted = std::make_shared<PostedRecv>(recvData, size);
+                        postedRecvs[std::make_tuple(msgType, context.getID(), srcVAddr, tag)].push_back(posted);
+                    }
                 }
-                else {
-                    //std::cout << "No message received" << std::endl;
+
+                if(result){
+                    size_t const n = std::min(size, message.size() - Message::headerSize);
+                    if(n > 0){
+                        memcpy (recvData, static_cast<std::int8_t*>(message.getData()), n);
+                    }
                 }
-                return false;
+
+                return posted;
             }
 
 
@@ -770,6 +1144,207 @@ namespace graybat {
             }
 
 
+            /**
+             * @brief Takes one credit for the peer behind *sendSocket_i*,
+             *        waits for the receiver to grant credits if none is left.
+             */
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::acquireCredit(std::size_t const sendSocket_i)
+            -> void {
+                std::unique_lock<std::mutex> lock(creditMtx);
+                creditCondition.wait(lock, [this, sendSocket_i]{ return sendCredits.at(sendSocket_i) > 0; });
+                sendCredits.at(sendSocket_i)--;
+
+            }
+
+            /**
+             * @brief Counts a received peer message and grants the credits
+             *        back to its sender in batches of half the credit window.
+             *        Credits are addressed within the initial context, thus
+             *        the sender can map them to its socket directly.
+             *
+             * @remark Only called by the receive handler.
+             */
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::grantCredit(ContextID const contextID, VAddr const srcVAddr)
+            -> void {
+                std::size_t const socket_i = sendSocketMappings.at(contextID).at(srcVAddr);
+                recvCounts.at(socket_i)++;
+
+                if(recvCounts.at(socket_i) >= std::max<size_t>(creditWindow / 2, 1)){
+                    std::array<size_t, 1> credits {{ recvCounts.at(socket_i) }};
+                    recvCounts.at(socket_i) = 0;
+                    static_cast<CommunicationPolicy*>(this)->asyncSendImpl(MsgType::CREDIT, 0, initialContext, socket_i, 0, credits);
+                }
+
+            }
+
+            /**
+             * @brief Takes the oldest receive posted for *key*.
+             *
+             * @remark postMtx has to be locked by the caller.
+             */
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::popPosted(std::tuple<MsgType, ContextID, VAddr, Tag> const &key)
+            -> std::shared_ptr<PostedRecv> {
+                auto it = postedRecvs.find(key);
+                if(it == postedRecvs.end()){
+                    return nullptr;
+                }
+                std::shared_ptr<PostedRecv> posted = it->second.front();
+                it->second.pop_front();
+                if(it->second.empty()){
+                    postedRecvs.erase(it);
+                }
+                return posted;
+
+            }
+
+            /**
+             * @brief Hands a completely received *message* to a receive that
+             *        was posted in the meantime or enqueues it to the inBox.
+             */
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::deliver(std::tuple<MsgType, ContextID, VAddr, Tag> const &key, Message &message)
+            -> void {
+                std::shared_ptr<PostedRecv> posted;
+                {
+                    std::lock_guard<std::mutex> lock(postMtx);
+                    posted = popPosted(key);
+                    if(posted){
+                        size_t const n = std::min(posted->size, message.size() - Message::headerSize);
+                        if(n > 0){
+                            memcpy (posted->data, static_cast<std::int8_t*>(message.getData()), n);
+                        }
+                    }
+                    else {
+                        inBox.enqueue(std::move(message), std::get<0>(key), std::get<1>(key), std::get<2>(key), std::get<3>(key));
+                    }
+                }
+
+                if(posted){
+                    posted->complete();
+                }
+
+            }
+
+            /**
+             * @brief Receives the announcement or the next chunk of a chunked
+             *        peer message. The chunks are received straight into the
+             *        buffer of a posted receive, or into a message that is
+             *        delivered once its last chunk arrived.
+             *
+             * @remark Only called by the receive handler.
+             */
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::recvChunk(Message &message)
+            -> void {
+
+                CommunicationPolicy *cp = static_cast<CommunicationPolicy*>(this);
+
+                auto id = std::make_tuple(message.getContextID(), message.getVAddr(), message.getMsgID());
+                auto it = transfers.find(id);
+
+                if(it == transfers.end()){
+                    std::array<std::uint64_t, 2> announce {{ 0, 0 }};
+                    cp->recvPayloadFromSocket(cp->recvSocket, message, reinterpret_cast<std::int8_t*>(announce.data()), sizeof(announce));
+
+                    Transfer &transfer = transfers[id];
+                    transfer.tag       = message.getTag();
+                    transfer.total     = announce[0];
+                    transfer.chunkSize = announce[1];
+                    transfer.offset    = 0;
+                    {
+                        std::lock_guard<std::mutex> lock(postMtx);
+                        transfer.posted = popPosted(std::make_tuple(MsgType::PEER, message.getContextID(), message.getVAddr(), message.getTag()));
+                    }
+
+                    if(transfer.posted){
+                        transfer.data     = transfer.posted->data;
+                        transfer.capacity = transfer.posted->size;
+                    }
+                    else {
+                        transfer.message  = Message::allocate(MsgType::PEER, message.getMsgID(), message.getContextID(), message.getVAddr(), message.getTag(), transfer.total);
+                        transfer.data     = transfer.message.getData();
+                        transfer.capacity = transfer.total;
+                    }
+                    return;
+                }
+
+                // Bytes beyond the posted buffer are dropped
+                Transfer &transfer = it->second;
+                size_t const length = std::min(transfer.chunkSize, transfer.total - transfer.offset);
+                size_t const offset = std::min(transfer.offset, transfer.capacity);
+                cp->recvPayloadFromSocket(cp->recvSocket, message, transfer.data + offset, std::min(length, transfer.capacity - offset));
+                transfer.offset += length;
+
+                if(transfer.offset >= transfer.total){
+                    if(transfer.posted){
+                        transfer.posted->complete();
+                    }
+                    else {
+                        deliver(std::make_tuple(MsgType::PEER, message.getContextID(), message.getVAddr(), transfer.tag), transfer.message);
+                    }
+                    transfers.erase(it);
+                }
+
+            }
+
+            /**
+             * @brief Splits a BATCH frame into its peer messages, which are
+             *        copied into posted receives or enqueued to the inBox.
+             *
+             * @remark Only called by the receive handler.
+             */
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::recvBatch(Message &message)
+            -> void {
+
+                std::int8_t const * frame = message.getData();
+                size_t const frameSize    = message.size() - Message::headerSize;
+                size_t msgOffset          = 0;
+
+                while(msgOffset < frameSize){
+                    MsgID msgID;
+                    ContextID contextID;
+                    VAddr srcVAddr;
+                    Tag tag;
+                    std::uint64_t size;
+                    memcpy (&msgID,     frame + msgOffset, sizeof(MsgID));         msgOffset += sizeof(MsgID);
+                    memcpy (&contextID, frame + msgOffset, sizeof(ContextID));     msgOffset += sizeof(ContextID);
+                    memcpy (&srcVAddr,  frame + msgOffset, sizeof(VAddr));         msgOffset += sizeof(VAddr);
+                    memcpy (&tag,       frame + msgOffset, sizeof(Tag));           msgOffset += sizeof(Tag);
+                    memcpy (&size,      frame + msgOffset, sizeof(std::uint64_t)); msgOffset += sizeof(std::uint64_t);
+                    std::int8_t const * payload = frame + msgOffset;
+                    msgOffset += size;
+
+                    auto key = std::make_tuple(MsgType::PEER, contextID, srcVAddr, tag);
+                    std::shared_ptr<PostedRecv> posted;
+                    {
+                        std::lock_guard<std::mutex> lock(postMtx);
+                        posted = popPosted(key);
+                        if(posted){
+                            size_t const n = std::min<size_t>(posted->size, size);
+                            if(n > 0){
+                                memcpy (posted->data, payload, n);
+                            }
+                        }
+                        else {
+                            Message record = Message::allocate(MsgType::PEER, msgID, contextID, srcVAddr, tag, size);
+                            if(size > 0){
+                                memcpy (record.getData(), payload, size);
+                            }
+                            inBox.enqueue(std::move(record), MsgType::PEER, contextID, srcVAddr, tag);
+                        }
+                    }
+
+                    if(posted){
+                        posted->complete();
+                    }
+                }
+
+            }
+
             template <typename T_CommunicationPolicy>
             auto Base<T_CommunicationPolicy>::handleRecv()
             -> void {
@@ -777,24 +1352,60 @@ namespace graybat {
                 using CommunicationPolicy = T_CommunicationPolicy;
                 using Message = graybat::communicationPolicy::socket::Message<CommunicationPolicy>;
 
+                CommunicationPolicy *cp = static_cast<CommunicationPolicy*>(this);
+
                 while(true){
 
                     Message message;
-                    static_cast<CommunicationPolicy*>(this)->recvFromSocket(static_cast<CommunicationPolicy*>(this)->recvSocket, message);
+                    cp->recvHeaderFromSocket(cp->recvSocket, message);
 
                     //std::cout << "recv handler: " << static_cast<int>(message.getMsgType()) << " " << message.getMsgID() << " " << message.getContextID() << " " << message.getVAddr() << " " << message.getTag() << std::endl;
 
                     if(message.getMsgType() == MsgType::DESTRUCT){
+                        cp->recvPayloadFromSocket(cp->recvSocket, message);
                         return;
                     }
 
+                    if(message.getMsgType() == MsgType::CHUNK){
+                        recvChunk(message);
+                        grantCredit(message.getContextID(), message.getVAddr());
+                        continue;
+                    }
+
+                    if(message.getMsgType() == MsgType::BATCH){
+                        cp->recvPayloadFromSocket(cp->recvSocket, message);
+                        recvBatch(message);
+                        grantCredit(message.getContextID(), message.getVAddr());
+                        continue;
+                    }
+
+                    auto key = std::make_tuple(message.getMsgType(), message.getContextID(), message.getVAddr(), message.getTag());
+
+                    std::shared_ptr<PostedRecv> posted;
+                    {
+                        std::lock_guard<std::mutex> lock(postMtx);
+                        posted = popPosted(key);
+                    }
+
+                    // Posted receive: payload goes straight into the user buffer
+                    if(posted){
+                        cp->recvPayloadFromSocket(cp->recvSocket, message, posted->data, posted->size);
+                    }
+                    else {
+                        cp->recvPayloadFromSocket(cp->recvSocket, message);
+                    }
+
                     if(message.getMsgType() == MsgType::PEER){
-                        std::array<unsigned,0>  null;
-                        Context context = contexts.at(message.getContextID());
-                        static_cast<CommunicationPolicy*>(this)->asyncSendImpl(MsgType::CONFIRM, message.getMsgID(), context, message.getVAddr(), message.getTag(), null);
+                        grantCredit(message.getContextID(), message.getVAddr());
                     }
 
-                    inBox.enqueue(std::move(message), message.getMsgType(), message.getContextID(), message.getVAddr(), message.getTag());
+                    if(posted){
+                        posted->complete();
+                    }
+                    else {
+                        // A receive might have been posted in the meantime
+                        deliver(key, message);
+                    }
 
                 }
 
@@ -818,14 +1429,66 @@ namespace graybat {
                         return;
                     }
 
-                    if(message.getMsgType() == MsgType::CONFIRM){
-                        ctrlBox.enqueue(std::move(message), message.getMsgType(), message.getContextID(), message.getVAddr(), message.getTag());
+                    if(message.getMsgType() == MsgType::CREDIT){
+                        // Credits are sent within the initial context, the vAddr is the socket index
+                        size_t credits = 0;
+                        memcpy (&credits, message.getData(), sizeof(credits));
+                        {
+                            std::lock_guard<std::mutex> lock(creditMtx);
+                            sendCredits.at(message.getVAddr()) += credits;
+                        }
+                        creditCondition.notify_all();
                     }
                     else {
                         // Throw exception
-                        throw std::runtime_error("Received wrong message type on ctrl socket (not confirm).");
+                        throw std::runtime_error("Received wrong message type on ctrl socket (not credit).");
+                    }
+
+                }
+
+            }
+
+            /**
+             * @brief Sends frames whose deadline passed. A frame that carries
+             *        a single message did not gain anything from waiting,
+             *        thus the delay of its lane is halved. Otherwise it is
+             *        doubled up to coalesceDelay.
+             */
+            template <typename T_CommunicationPolicy>
+            auto Base<T_CommunicationPolicy>::handleFlush()
+            -> void {
+
+                std::size_t const nLanes = static_cast<CommunicationPolicy*>(this)->sendSockets.size();
+
+                std::unique_lock<std::mutex> lock(flushMtx);
+                while(!flushStop){
+                    flushWakeup = false;
+                    lock.unlock();
+
+                    auto const now = std::chrono::steady_clock::now();
+                    auto next = now + coalesceDelay;
+                    for(std::size_t socket_i = 0; socket_i < nLanes; ++socket_i){
+                        SendLane &lane = sendLanes[socket_i];
+                        std::lock_guard<std::mutex> dataLock(lane.data);
+                        if(lane.batch.empty()){
+                            continue;
+                        }
+                        if(lane.deadline <= now){
+                            if(lane.records > 1){
+                                lane.delay = std::min(lane.delay * 2, coalesceDelay);
+                            }
+                            else {
+                                lane.delay = std::max(lane.delay / 2, std::chrono::microseconds(1));
+                            }
+                            flushLane(socket_i);
+                        }
+                        else {
+                            next = std::min(next, lane.deadline);
+                        }
                     }
 
+                    lock.lock();
+                    flushCondition.wait_until(lock, next, [this]{ return flushStop || flushWakeup; });
                 }
 
             }
@@ -0,0 +1,146 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <atomic>             /* std::atomic */
+#include <condition_variable> /* std::condition_variable */
+#include <mutex>              /* std::mutex, std::unique_lock */
+#include <map>                /* std::map */
+#include <memory>             /* std::shared_ptr, std::weak_ptr */
+#include <vector>             /* std::vector */
+
+// graybat
+#include <graybat/communicationPolicy/socket/Notifier.hpp> /* Notifier */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace socket {
+
+            /**
+             * @brief Keeps track of sends whose buffer is still in use by
+             *        the transport. A send that is not pending is complete,
+             *        thus its buffer can be reused. A send that is split
+             *        into several messages holds one ticket per message.
+             *
+             */
+            template <typename T_MsgID>
+            class CompletionTable {
+
+            public:
+                /**
+                 * @brief Handed to the transport as hint of its release
+                 *        function, which completes the send of *msgID*.
+                 */
+                struct Ticket {
+                    CompletionTable * table;
+                    T_MsgID msgID;
+                };
+
+                /**
+                 * @brief Marks *msgID* as pending and returns a ticket, the send
+                 *        is complete once all its tickets are released. The
+                 *        ticket is deleted by release.
+                 */
+                Ticket * add(T_MsgID const msgID){
+                    std::lock_guard<std::mutex> lock(mtx);
+                    pending[msgID]++;
+                    tickets++;
+                    return new Ticket{this, msgID};
+                }
+
+                void complete(T_MsgID const msgID){
+                    std::lock_guard<std::mutex> lock(mtx);
+                    auto it = pending.find(msgID);
+                    if(it != pending.end()){
+                        tickets--;
+                        if(--it->second == 0){
+                            pending.erase(it);
+                            cv.notify_all();
+                            notifyAll();
+                        }
+                    }
+                }
+
+                bool test(T_MsgID const msgID){
+                    // Nothing pending at all, polling does not need the lock
+                    if(tickets.load(std::memory_order_acquire) == 0){
+                        return true;
+                    }
+                    std::lock_guard<std::mutex> lock(mtx);
+                    return pending.count(msgID) == 0;
+                }
+
+                void wait(T_MsgID const msgID){
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [this, msgID]{ return pending.count(msgID) == 0; });
+                }
+
+                /**
+                 * @brief *notifier* is notified whenever a send completes
+                 *        as long as it is alive.
+                 */
+                void subscribe(std::shared_ptr<Notifier> const &notifier){
+                    std::lock_guard<std::mutex> lock(mtx);
+                    notifiers.push_back(notifier);
+                }
+
+                /**
+                 * @brief Release function with the signature of zmq_free_fn.
+                 */
+                static void release(void *, void * hint){
+                    Ticket * ticket = static_cast<Ticket*>(hint);
+                    ticket->table->complete(ticket->msgID);
+                    delete ticket;
+                }
+
+            private:
+                // mtx has to be locked by the caller
+                void notifyAll(){
+                    auto it = notifiers.begin();
+                    while(it != notifiers.end()){
+                        std::shared_ptr<Notifier> notifier = it->lock();
+                        if(notifier){
+                            notifier->notify();
+                            ++it;
+                        }
+                        else {
+                            it = notifiers.erase(it);
+                        }
+                    }
+                }
+
+                std::mutex mtx;
+                std::condition_variable cv;
+                std::map<T_MsgID, std::size_t> pending;
+                std::atomic<std::size_t> tickets {0};
+                std::vector<std::weak_ptr<Notifier> > notifiers;
+
+            };
+
+        } // socket
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
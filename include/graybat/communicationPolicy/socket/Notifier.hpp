@@ -0,0 +1,82 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <condition_variable> /* std::condition_variable */
+#include <cstdint>            /* std::uint64_t */
+#include <mutex>              /* std::mutex, std::unique_lock */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace socket {
+
+            /**
+             * @brief Wakes up a thread that waits for any operation of
+             *        a set to finish. Operations notify every notifier
+             *        subscribed to them when they finish. The generation
+             *        counts notifications, thus a notification between
+             *        testing the operations and waiting is not lost.
+             *
+             */
+            class Notifier {
+
+            public:
+                Notifier() :
+                    count(0){
+
+                }
+
+                void notify(){
+                    {
+                        std::lock_guard<std::mutex> lock(mtx);
+                        count++;
+                    }
+                    cv.notify_all();
+                }
+
+                std::uint64_t generation(){
+                    std::lock_guard<std::mutex> lock(mtx);
+                    return count;
+                }
+
+                /**
+                 * @brief Blocks until a notification after *seen* arrived.
+                 */
+                void wait(std::uint64_t const seen){
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [this, seen]{ return count != seen; });
+                }
+
+            private:
+                std::mutex mtx;
+                std::condition_variable cv;
+                std::uint64_t count;
+
+            };
+
+        } // socket
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <atomic>             /* std::atomic */
+#include <condition_variable> /* std::condition_variable */
+#include <cstdint>            /* std::int8_t */
+#include <memory>             /* std::shared_ptr */
+#include <mutex>              /* std::mutex, std::unique_lock */
+#include <vector>             /* std::vector */
+
+// graybat
+#include <graybat/communicationPolicy/socket/Notifier.hpp> /* Notifier */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace socket {
+
+            /**
+             * @brief Receive buffer that was posted before its message
+             *        arrived. The receive handler writes the payload of
+             *        the matching message straight into this buffer.
+             *
+             */
+            struct PostedRecv {
+
+                PostedRecv(std::int8_t * data, size_t const size) :
+                    data(data),
+                    size(size),
+                    done(false){
+
+                }
+
+                void complete(){
+                    std::lock_guard<std::mutex> lock(mtx);
+                    done.store(true, std::memory_order_release);
+                    cv.notify_all();
+                    for(std::shared_ptr<Notifier> &notifier : notifiers){
+                        notifier->notify();
+                    }
+                    notifiers.clear();
+                }
+
+                /**
+                 * @brief *notifier* is notified when the receive completes,
+                 *        at once when it is already complete.
+                 */
+                void subscribe(std::shared_ptr<Notifier> const &notifier){
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if(done.load(std::memory_order_relaxed)){
+                        notifier->notify();
+                    }
+                    else {
+                        notifiers.push_back(notifier);
+                    }
+                }
+
+                /**
+                 * @brief Does not lock, thus it can be polled.
+                 */
+                bool test(){
+                    return done.load(std::memory_order_acquire);
+                }
+
+                void wait(){
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [this]{ return done.load(std::memory_order_acquire); });
+                }
+
+                std::int8_t * const data;
+                size_t const size;
+
+            private:
+                std::atomic<bool> done;
+                std::mutex mtx;
+                std::condition_variable cv;
+                std::vector<std::shared_ptr<Notifier> > notifiers;
+
+            };
+
+        } // socket
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
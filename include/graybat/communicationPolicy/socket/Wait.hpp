@@ -0,0 +1,85 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <thread> /* std::this_thread::yield */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace socket {
+
+            enum class WaitMode { BLOCK, ADAPTIVE, SPIN };
+
+            /**
+             * @brief Describes how an event is waited for. ADAPTIVE
+             *        polls *spins* times, then polls *yields* times
+             *        while yielding the core and finally blocks until
+             *        the operation is finished. SPIN never blocks and
+             *        BLOCK blocks at once.
+             *
+             */
+            struct WaitStrategy {
+                WaitMode mode   = WaitMode::ADAPTIVE;
+                unsigned spins  = 1000;
+                unsigned yields = 100;
+            };
+
+            /**
+             * @brief Waits according to *strategy* until *test* returns
+             *        true. *block* has to return once *test* would
+             *        return true.
+             */
+            template <typename T_Test, typename T_Block>
+            void waitFor(WaitStrategy const &strategy, T_Test test, T_Block block){
+                if(strategy.mode != WaitMode::BLOCK){
+                    for(unsigned i = 0; i < strategy.spins; ++i){
+                        if(test()){
+                            return;
+                        }
+                    }
+
+                    for(unsigned i = 0; i < strategy.yields; ++i){
+                        if(test()){
+                            return;
+                        }
+                        std::this_thread::yield();
+                    }
+
+                    if(strategy.mode == WaitMode::SPIN){
+                        while(!test()){
+                            std::this_thread::yield();
+                        }
+                        return;
+                    }
+                }
+
+                block();
+
+            }
+
+        } // socket
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
@@ -0,0 +1,110 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <memory>  /* std::shared_ptr */
+#include <utility> /* std::move */
+
+// graybat
+#include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/threads/Mailbox.hpp> /* Mailbox */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace threads {
+
+            /**
+             * @brief An event is returned by non-blocking
+             *        communication operations and can be
+             *        asked whether an operation has finished
+             *        or it can be waited for this operation to
+             *        be finished.
+             *
+             */
+            template <typename T_CP>
+            class Event {
+            public:
+
+                using VAddr     = typename graybat::communicationPolicy::VAddr<T_CP>;
+                using Tag       = typename graybat::communicationPolicy::Tag<T_CP>;
+                using Context   = typename graybat::communicationPolicy::Context<T_CP>;
+                using Posted    = typename Mailbox<T_CP>::Posted;
+
+                Event(Context context, VAddr vAddr, Tag tag, T_CP& comm) :
+                    context(context),
+                    vAddr(vAddr),
+                    tag(tag),
+                    comm(&comm) {
+
+                }
+
+                /**
+                 * @brief Event of the receive *posted*, which is finished
+                 *        by the thread that delivers its message.
+                 */
+                Event(Context context, VAddr vAddr, Tag tag, std::shared_ptr<Posted> posted, T_CP& comm) :
+                    context(context),
+                    vAddr(vAddr),
+                    tag(tag),
+                    posted(std::move(posted)),
+                    comm(&comm) {
+
+                }
+
+                Event& operator=(const Event&) = default;
+
+                void wait(){
+                    if(posted){
+                        comm->inBox.wait(*posted);
+                    }
+
+                }
+
+                bool ready(){
+                    return !posted || posted->done;
+                }
+
+                VAddr source(){
+                    return vAddr;
+                }
+
+                Tag getTag(){
+                    return tag;
+
+                }
+
+                Context    context;
+                VAddr      vAddr;
+                Tag        tag;
+                std::shared_ptr<Posted> posted;
+                T_CP *     comm;
+
+            };
+
+        } // threads
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
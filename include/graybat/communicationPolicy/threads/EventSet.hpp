@@ -0,0 +1,125 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef>   /* std::size_t */
+#include <stdexcept> /* std::runtime_error */
+#include <thread>    /* std::this_thread::yield */
+#include <utility>   /* std::move */
+#include <vector>    /* std::vector */
+
+// graybat
+#include <graybat/communicationPolicy/Traits.hpp>
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace threads {
+
+            /**
+             * @brief Set of events of the threads policy. Receives of
+             *        this policy are finished by the delivering thread,
+             *        waitAny tests the events in turn.
+             *
+             */
+            template <typename T_CP>
+            class EventSet {
+            public:
+
+                using Event = typename graybat::communicationPolicy::Event<T_CP>;
+
+                void push_back(Event const &event){
+                    events.push_back(event);
+                }
+
+                std::size_t size() const {
+                    return events.size();
+                }
+
+                bool empty() const {
+                    return events.empty();
+                }
+
+                /**
+                 * @brief Waits for all events and clears the set.
+                 */
+                void waitAll(){
+                    for(Event &e : events){
+                        e.wait();
+                    }
+                    events.clear();
+
+                }
+
+                /**
+                 * @brief Waits until one event finished, removes it from
+                 *        the set and returns it.
+                 */
+                Event waitAny(){
+                    if(events.empty()){
+                        throw std::runtime_error("waitAny on an empty EventSet.");
+                    }
+
+                    while(true){
+                        for(std::size_t i = 0; i < events.size(); ++i){
+                            if(events[i].ready()){
+                                Event event = events[i];
+                                events.erase(events.begin() + i);
+                                return event;
+                            }
+                        }
+                        std::this_thread::yield();
+                    }
+
+                }
+
+                /**
+                 * @brief Removes all finished events from the set and
+                 *        returns them, does not block.
+                 */
+                std::vector<Event> testSome(){
+                    std::vector<Event> finished;
+                    std::vector<Event> pending;
+                    for(Event &e : events){
+                        if(e.ready()){
+                            finished.push_back(e);
+                        }
+                        else {
+                            pending.push_back(e);
+                        }
+                    }
+                    events = std::move(pending);
+                    return finished;
+
+                }
+
+            private:
+                std::vector<Event> events;
+
+            };
+
+        } // threads
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
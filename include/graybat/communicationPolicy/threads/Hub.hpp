@@ -0,0 +1,136 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <condition_variable> /* std::condition_variable */
+#include <map>                /* std::map */
+#include <memory>             /* std::shared_ptr */
+#include <mutex>              /* std::mutex, std::unique_lock */
+#include <string>             /* std::string */
+#include <vector>             /* std::vector */
+
+// GrayBat
+#include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/threads/Mailbox.hpp> /* Mailbox */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace threads {
+
+            /**
+             * @brief Process wide meeting point of thread peers.
+             *
+             * Takes over the role of the signaling server: peers that
+             * join with the same context name form the initial context
+             * and get to know the inboxes of each other.
+             *
+             */
+            template <typename T_CommunicationPolicy>
+            class Hub {
+
+                using CommunicationPolicy = T_CommunicationPolicy;
+                using ContextID           = graybat::communicationPolicy::ContextID<CommunicationPolicy>;
+                using VAddr               = graybat::communicationPolicy::VAddr<CommunicationPolicy>;
+
+            public:
+                struct Group {
+                    ContextID contextID;
+                    size_t size;
+                    size_t left;
+                    std::vector<Mailbox<CommunicationPolicy>*> peers;
+                };
+
+                static Hub& instance(){
+                    static Hub hub;
+                    return hub;
+                }
+
+                /**
+                 * @brief Blocks until *contextSize* peers joined the context *contextName*.
+                 *
+                 * @return Group of all peers and the vAddr of the joining peer
+                 */
+                std::pair<std::shared_ptr<Group>, VAddr> join(std::string const contextName, size_t const contextSize, Mailbox<CommunicationPolicy> &inBox){
+                    std::unique_lock<std::mutex> lock(mtx);
+
+                    std::shared_ptr<Group> &pending = groups[contextName];
+                    if(!pending){
+                        pending = std::make_shared<Group>();
+                        pending->contextID = maxContextID++;
+                        pending->size      = contextSize;
+                        pending->left      = 0;
+                    }
+
+                    std::shared_ptr<Group> group = pending;
+                    VAddr vAddr = group->peers.size();
+                    group->peers.push_back(&inBox);
+
+                    // Complete groups make room for the next group with this name
+                    if(group->peers.size() == group->size){
+                        groups.erase(contextName);
+                        cv.notify_all();
+                    }
+
+                    cv.wait(lock, [&group]{ return group->peers.size() == group->size; });
+                    return std::make_pair(group, vAddr);
+
+                }
+
+                /**
+                 * @brief Blocks until all peers of *group* left, thus no
+                 *        inbox of the group is used after its destruction.
+                 */
+                void leave(std::shared_ptr<Group> group){
+                    std::unique_lock<std::mutex> lock(mtx);
+                    group->left++;
+                    cv.notify_all();
+                    cv.wait(lock, [&group]{ return group->left == group->size; });
+
+                }
+
+                ContextID getContextID(){
+                    std::lock_guard<std::mutex> lock(mtx);
+                    return maxContextID++;
+
+                }
+
+            private:
+                Hub() :
+                    maxContextID(0){
+
+                }
+
+                std::mutex mtx;
+                std::condition_variable cv;
+                ContextID maxContextID;
+                std::map<std::string, std::shared_ptr<Group> > groups;
+
+            };
+
+        } // threads
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
@@ -0,0 +1,194 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <algorithm>          /* std::min */
+#include <atomic>             /* std::atomic */
+#include <condition_variable> /* std::condition_variable */
+#include <cstdint>            /* std::int8_t */
+#include <cstring>            /* memcpy */
+#include <deque>              /* std::deque */
+#include <map>                /* std::map */
+#include <memory>             /* std::shared_ptr */
+#include <mutex>              /* std::mutex, std::unique_lock */
+#include <tuple>              /* std::tuple */
+#include <vector>             /* std::vector */
+
+// GrayBat
+#include <graybat/communicationPolicy/Traits.hpp>
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace threads {
+
+            /**
+             * @brief Inbox of a thread peer.
+             *
+             * Messages are delivered by the sending thread. Receives are
+             * posted in FIFO order per key, a delivered message is copied
+             * straight into the buffer of the oldest posted receive of
+             * its key. Otherwise the data is queued in an owned buffer
+             * and copied a second time into the buffer of the receive
+             * that takes it.
+             *
+             */
+            template <typename T_CommunicationPolicy>
+            class Mailbox {
+
+                using CommunicationPolicy = T_CommunicationPolicy;
+                using ContextID           = graybat::communicationPolicy::ContextID<CommunicationPolicy>;
+                using VAddr               = graybat::communicationPolicy::VAddr<CommunicationPolicy>;
+                using Tag                 = graybat::communicationPolicy::Tag<CommunicationPolicy>;
+                using MsgType             = graybat::communicationPolicy::MsgType<CommunicationPolicy>;
+
+            public:
+                using Key     = std::tuple<MsgType, ContextID, VAddr, Tag>;
+                using Message = std::vector<std::int8_t>;
+
+                // Receive buffer that waits for its message
+                struct Posted {
+                    std::int8_t * data;
+                    size_t size;
+                    std::atomic<bool> done;
+                };
+
+                /**
+                 * @brief Delivers *size* bytes of *data* with *key* to this inbox.
+                 */
+                void deliver(Key const key, std::int8_t const * data, size_t const size){
+                    std::unique_lock<std::mutex> lock(mtx);
+
+                    auto it = posted.find(key);
+                    if(it != posted.end()){
+                        std::shared_ptr<Posted> recv = std::move(it->second.front());
+                        it->second.pop_front();
+                        if(it->second.empty()){
+                            posted.erase(it);
+                        }
+
+                        // The receive is not visible to other senders anymore
+                        lock.unlock();
+                        memcpy(recv->data, data, std::min(size, recv->size));
+                        lock.lock();
+                        recv->done = true;
+                        cv.notify_all();
+                        return;
+                    }
+
+                    queues[key].emplace_back(data, data + size);
+                    cv.notify_all();
+
+                }
+
+                /**
+                 * @brief Posts *data* as receive buffer of the next message
+                 *        with *key*. A message that is already queued is
+                 *        received at once.
+                 */
+                std::shared_ptr<Posted> post(Key const key, std::int8_t * data, size_t const size){
+                    std::shared_ptr<Posted> recv(new Posted{data, size, {false}});
+                    std::unique_lock<std::mutex> lock(mtx);
+
+                    auto it = queues.find(key);
+                    if(it != queues.end()){
+                        Message message = pop(it);
+                        lock.unlock();
+                        memcpy(data, message.data(), std::min(size, message.size()));
+                        recv->done = true;
+                        return recv;
+                    }
+
+                    posted[key].push_back(recv);
+                    return recv;
+
+                }
+
+                /**
+                 * @brief Blocks until the posted receive *recv* finished.
+                 */
+                void wait(Posted const &recv){
+                    if(recv.done){
+                        return;
+                    }
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [&recv]{ return recv.done.load(); });
+
+                }
+
+                /**
+                 * @brief Blocks until a message with *key* was received into *data*.
+                 */
+                void recv(Key const key, std::int8_t * data, size_t const size){
+                    wait(*post(key, data, size));
+
+                }
+
+                /**
+                 * @brief Blocks until a message with *msgType* and *contextID* from
+                 *        an arbitrary peer was received into *data*.
+                 *
+                 * @return Key of the received message
+                 */
+                Key recv(MsgType const msgType, ContextID const contextID, std::int8_t * data, size_t const size){
+                    std::unique_lock<std::mutex> lock(mtx);
+
+                    auto it = queues.end();
+                    cv.wait(lock, [&]{
+                            it = queues.lower_bound(Key(msgType, contextID, 0, 0));
+                            return it != queues.end() &&
+                                   std::get<0>(it->first) == msgType &&
+                                   std::get<1>(it->first) == contextID;
+                        });
+
+                    Key key = it->first;
+                    Message message = pop(it);
+                    lock.unlock();
+                    memcpy(data, message.data(), std::min(size, message.size()));
+                    return key;
+
+                }
+
+            private:
+                std::mutex mtx;
+                std::condition_variable cv;
+                std::map<Key, std::deque<Message> > queues;
+                std::map<Key, std::deque<std::shared_ptr<Posted> > > posted;
+
+                Message pop(typename std::map<Key, std::deque<Message> >::iterator it){
+                    Message message = std::move(it->second.front());
+                    it->second.pop_front();
+                    if(it->second.empty()){
+                        queues.erase(it);
+                    }
+                    return message;
+                }
+
+            };
+
+        } // threads
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <graybat/communicationPolicy/socket/Wait.hpp> /* WaitStrategy */
+
 namespace graybat {
     
     namespace communicationPolicy {
@@ -33,6 +35,31 @@ namespace graybat {
                 size_t contextSize;
                 std::string contextName = "context";
                 size_t maxBufferSize = 100 * 1000 * 1000;
+                // Peer messages that may be in flight to one peer before
+                // the sender waits for credits granted by the receiver
+                size_t credits = 64;
+                // Send data straight from the buffer of the caller, which
+                // then has to stay valid until the send event is finished
+                bool zeroCopy = false;
+                // Number of zmq I/O threads
+                int ioThreads = 1;
+                // Payloads above stripeThreshold bytes are split across
+                // this number of connections to the destination peer
+                size_t streams = 1;
+                size_t stripeThreshold = 4 * 1024 * 1024;
+                // Peer messages above chunkSize bytes are sent as a
+                // sequence of chunks, each chunk takes one credit
+                size_t chunkSize = 16 * 1024 * 1024;
+                // Peer messages up to coalesceThreshold bytes are packed
+                // into frames of up to coalesceSize bytes per destination.
+                // A frame is sent when full, when it is older than the
+                // adaptive delay (at most coalesceDelay microseconds) or
+                // on flush. A coalesceSize of 0 disables coalescing.
+                size_t coalesceSize = 64 * 1024;
+                size_t coalesceThreshold = 1024;
+                size_t coalesceDelay = 100;
+                // How events are waited for when no strategy is given
+                socket::WaitStrategy waitStrategy {};
             };
 
         } // zmq
@@ -21,7 +21,12 @@
 #pragma once
 
 // STL
-#include <numeric>
+#include <algorithm> /* std::find */
+#include <cstddef>   /* std::size_t */
+#include <numeric>   /* std::iota */
+#include <stdexcept> /* std::out_of_range */
+#include <string>    /* std::to_string */
+#include <vector>    /* std::vector */
 
 // GRAYBAT
 #include <graybat/communicationPolicy/Traits.hpp>
@@ -93,6 +98,26 @@ namespace graybat {
                     return isValid;
                 }
 
+                /**
+                 * @brief Position of *vAddr* in the member list. Split
+                 *        contexts keep the VAddrs of their parent, thus
+                 *        the VAddrs of the members need not be contiguous.
+                 */
+                std::size_t rankOf(VAddr const vAddr) const {
+                    auto it = std::find(peers.begin(), peers.end(), vAddr);
+                    if(it == peers.end()){
+                        throw std::out_of_range("VAddr " + std::to_string(vAddr) + " is no member of context " + std::to_string(contextID) + ".");
+                    }
+                    return static_cast<std::size_t>(it - peers.begin());
+                }
+
+                /**
+                 * @brief VAddr of the member at position *rank*.
+                 */
+                VAddr vAddrOf(std::size_t const rank) const {
+                    return peers.at(rank);
+                }
+
                 std::vector<VAddr>::iterator begin(){
                     return peers.begin();
                 }
@@ -21,10 +21,12 @@
 #pragma once
 
 // STL
-#include <memory> /* std::unique_ptr */
+#include <memory> /* std::shared_ptr */
 
 // graybat
 #include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/socket/PostedRecv.hpp> /* PostedRecv */
+#include <graybat/communicationPolicy/socket/Wait.hpp>       /* WaitStrategy */
 
 namespace graybat {
 
@@ -56,46 +58,77 @@ namespace graybat {
                     context(context),
                     vAddr(vAddr),
                     tag(tag),
-                    buf(nullptr),
-                    size(0),
+                    isRecv(false),
                     done(false),
                     comm(&comm) {
 
                 }
 
-                template<typename T_Buf>
-                Event(MsgID msgID, Context context, VAddr vAddr, Tag tag, T_Buf & buf, bool done, T_CP& comm) :
+                /**
+                 * @brief Event of a receive. It is done when *posted* is
+                 *        nullptr, otherwise when the receive handler has
+                 *        completed the posted receive.
+                 */
+                Event(MsgID msgID, Context context, VAddr vAddr, Tag tag, std::shared_ptr<socket::PostedRecv> posted, T_CP& comm) :
                     msgID(msgID),
                     context(context),
                     vAddr(vAddr),
                     tag(tag),
-                    buf(reinterpret_cast<std::int8_t*>(buf.data())),
-                    size(sizeof(typename T_Buf::value_type) * buf.size()),
-                    done(done),
+                    posted(posted),
+                    isRecv(true),
+                    done(posted == nullptr),
                     comm(&comm) {
 
                 }
 
                 Event& operator=(const Event&) = default;
 
+                /**
+                 * @brief Waits with the strategy of the communication policy.
+                 */
                 void wait(){
-                    while(!ready());
+                    wait(comm->waitStrategy);
+
+                }
+
+                /**
+                 * @brief Waits with *strategy*, spinning pays off for operations
+                 *        that are expected to finish soon.
+                 */
+                void wait(socket::WaitStrategy const &strategy){
+                    if(done){
+                        return;
+                    }
+
+                    if(isRecv){
+                        // The awaited message might depend on messages
+                        // still waiting in a coalescing frame
+                        comm->flush();
+                        socket::waitFor(strategy,
+                                        [this]{ return posted->test(); },
+                                        [this]{ posted->wait(); });
+                    }
+                    else {
+                        socket::waitFor(strategy,
+                                        [this]{ return comm->ready(msgID, context, vAddr, tag); },
+                                        [this]{ comm->wait(msgID, context, vAddr, tag); });
+                    }
+                    done = true;
 
                 }
 
                 bool ready(){
-                    //std::cout << "ready? size: " << size << std::endl;
                     if(done == true){
                         return true;
                     }
                     else {
-                        if(buf == nullptr){
-                            // asyncSend Event
-                            done = comm->ready(msgID, context, vAddr, tag);
+                        if(isRecv){
+                            // asyncRecv Event
+                            done = posted->test();
                         }
                         else {
-                            // asyncRecv Event
-                            done = comm->asyncRecvImpl(MsgType::PEER, context, vAddr, tag, buf, size);
+                            // asyncSend Event
+                            done = comm->ready(msgID, context, vAddr, tag);
                         }
                     }
                     return done;
@@ -114,8 +147,8 @@ namespace graybat {
                 Context    context;
                 VAddr      vAddr;
                 Tag        tag;
-                std::int8_t * buf;
-                size_t size;
+                std::shared_ptr<socket::PostedRecv> posted;
+                bool       isRecv;
                 bool       done;
                 T_CP *     comm;
 
@@ -0,0 +1,165 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef>   /* std::size_t */
+#include <memory>    /* std::shared_ptr */
+#include <stdexcept> /* std::runtime_error */
+#include <utility>   /* std::move */
+#include <vector>    /* std::vector */
+
+// graybat
+#include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/socket/Notifier.hpp> /* Notifier */
+#include <graybat/communicationPolicy/socket/Wait.hpp>     /* waitFor */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace zmq {
+
+            /**
+             * @brief Set of events of the socket based policies. Its
+             *        notifier is subscribed to the posted receives and to
+             *        the send completions of its events, thus waitAny
+             *        sleeps until one of them finishes instead of polling.
+             *
+             */
+            template <typename T_CP>
+            class EventSet {
+            public:
+
+                using Event = typename graybat::communicationPolicy::Event<T_CP>;
+
+                EventSet() :
+                    notifier(std::make_shared<socket::Notifier>()),
+                    sendSubscribed(false){
+
+                }
+
+                void push_back(Event const &event){
+                    events.push_back(event);
+                    Event &e = events.back();
+
+                    if(e.isRecv){
+                        if(e.posted){
+                            e.posted->subscribe(notifier);
+                        }
+                    }
+                    else if(!sendSubscribed){
+                        e.comm->completions.subscribe(notifier);
+                        sendSubscribed = true;
+                    }
+                }
+
+                std::size_t size() const {
+                    return events.size();
+                }
+
+                bool empty() const {
+                    return events.empty();
+                }
+
+                /**
+                 * @brief Waits for all events and clears the set.
+                 */
+                void waitAll(){
+                    for(Event &e : events){
+                        e.wait();
+                    }
+                    events.clear();
+
+                }
+
+                /**
+                 * @brief Waits until one event finished, removes it from
+                 *        the set and returns it.
+                 */
+                Event waitAny(){
+                    if(events.empty()){
+                        throw std::runtime_error("waitAny on an empty EventSet.");
+                    }
+
+                    // The awaited messages might depend on messages
+                    // still waiting in a coalescing frame
+                    events.front().comm->flush();
+
+                    std::size_t found = events.size();
+                    auto test = [this, &found]{
+                        for(std::size_t i = 0; i < events.size(); ++i){
+                            if(events[i].ready()){
+                                found = i;
+                                return true;
+                            }
+                        }
+                        return false;
+                    };
+
+                    socket::waitFor(events.front().comm->waitStrategy, test, [this, &test]{
+                            while(true){
+                                auto const seen = notifier->generation();
+                                if(test()){
+                                    return;
+                                }
+                                notifier->wait(seen);
+                            }
+                        });
+
+                    Event event = events[found];
+                    events.erase(events.begin() + found);
+                    return event;
+
+                }
+
+                /**
+                 * @brief Removes all finished events from the set and
+                 *        returns them, does not block.
+                 */
+                std::vector<Event> testSome(){
+                    std::vector<Event> finished;
+                    std::vector<Event> pending;
+                    for(Event &e : events){
+                        if(e.ready()){
+                            finished.push_back(e);
+                        }
+                        else {
+                            pending.push_back(e);
+                        }
+                    }
+                    events = std::move(pending);
+                    return finished;
+
+                }
+
+            private:
+                std::vector<Event> events;
+                std::shared_ptr<socket::Notifier> notifier;
+                bool sendSubscribed;
+
+            };
+
+        } // zmq
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
@@ -20,6 +20,11 @@
 
 #pragma once
 
+// STL
+#include <cstdint> /* std::int8_t */
+#include <cstring> /* memcpy */
+#include <vector>  /* std::vector */
+
 #include <graybat/communicationPolicy/Traits.hpp>
 
 namespace graybat {
@@ -28,6 +33,15 @@ namespace graybat {
     
         namespace zmq {
 
+            /**
+             * @brief Message of the zmq policy.
+             *
+             * A message consists of two frames, the header and the
+             * payload. The payload is either a copy of the data, the
+             * data buffer of the caller itself (zero copy) or a vector
+             * that was moved into the message.
+             *
+             */
             template <typename T_CommunicationPolicy>
             struct Message {
 
@@ -38,41 +52,117 @@ namespace graybat {
                 using Tag                 = typename graybat::communicationPolicy::Tag<CommunicationPolicy>;                
                 using MsgType             = typename graybat::communicationPolicy::MsgType<CommunicationPolicy>;
                 using MsgID               = typename graybat::communicationPolicy::MsgID<CommunicationPolicy>;
+                using Release             = void (void *, void *);
+
+                static constexpr size_t headerSize = sizeof(MsgType) +
+                                                     sizeof(MsgID) +
+                                                     sizeof(ContextID) +
+                                                     sizeof(VAddr) +
+                                                     sizeof(Tag);
 
                 // Members
-                ::zmq::message_t message;
+                ::zmq::message_t header;
+                ::zmq::message_t payload;
+                // Payload was received before the header was handed out
+                bool assembled;
 
                 // Methods
-                Message(){
+                Message() :
+                    assembled(false){
 
                 }
-                
+
+                /**
+                 * @param[in] release  If given, the payload frame is build on top
+                 *                     of the buffer of *data* and release(data, hint)
+                 *                     is called once zmq does not need the buffer
+                 *                     anymore. Otherwise *data* is copied.
+                 */
                 template <typename T_Data>
                 Message(MsgType const msgType,  
                         MsgID const msgID,
                         ContextID const contextID,
                         VAddr const srcVAddr,
                         Tag const tag,      
-                        T_Data & data) : message(sizeof(MsgType) +
-                                                       sizeof(MsgID) +
-                                                       sizeof(ContextID) +
-                                                       sizeof(VAddr) +
-                                                       sizeof(Tag) +
-                                                       data.size() * sizeof(typename T_Data::value_type)){
+                        T_Data & data,
+                        Release * release = nullptr,
+                        void * hint = nullptr) : header(headerSize),
+                                                 assembled(false){
+
+                    writeHeader(msgType, msgID, contextID, srcVAddr, tag);
+
+                    size_t const size = data.size() * sizeof(typename T_Data::value_type);
+                    if(size == 0){
+                        if(release){
+                            release(nullptr, hint);
+                        }
+                        return;
+                    }
+
+                    if(release){
+                        payload.rebuild(const_cast<void*>(static_cast<void const*>(data.data())), size, release, hint);
+                    }
+                    else {
+                        payload.rebuild(size);
+                        memcpy (static_cast<char*>(payload.data()), data.data(), size);
+                    }
 
-                    size_t    msgOffset(0);
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, &msgType,    sizeof(MsgType));   msgOffset += sizeof(MsgType);
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, &msgID,      sizeof(MsgID));     msgOffset += sizeof(MsgID);		
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, &contextID,  sizeof(ContextID)); msgOffset += sizeof(ContextID);
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, &srcVAddr,   sizeof(VAddr));     msgOffset += sizeof(VAddr);
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, &tag,        sizeof(Tag));       msgOffset += sizeof(Tag);
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, data.data(), sizeof(typename T_Data::value_type) * data.size());
+                }
+
+                /**
+                 * @brief The payload frame takes ownership of the moved in *data*
+                 *        and releases it when the message was transmitted. The
+                 *        buffer of the caller is free at once, thus *release* is
+                 *        called immediately.
+                 */
+                template <typename T_Value>
+                Message(MsgType const msgType,
+                        MsgID const msgID,
+                        ContextID const contextID,
+                        VAddr const srcVAddr,
+                        Tag const tag,
+                        std::vector<T_Value> && data,
+                        Release * release = nullptr,
+                        void * hint = nullptr) : header(headerSize),
+                                                 assembled(false){
+
+                    writeHeader(msgType, msgID, contextID, srcVAddr, tag);
+
+                    if(release){
+                        release(nullptr, hint);
+                    }
+
+                    if(data.empty()){
+                        return;
+                    }
+
+                    std::vector<T_Value> * owned = new std::vector<T_Value>(std::move(data));
+                    payload.rebuild(owned->data(), owned->size() * sizeof(T_Value), &destroy<T_Value>, owned);
+
+                }
+
+                /**
+                 * @brief Creates a message with an uninitialized payload of
+                 *        *size* bytes, which is filled through getData().
+                 */
+                static Message allocate(MsgType const msgType,
+                                        MsgID const msgID,
+                                        ContextID const contextID,
+                                        VAddr const srcVAddr,
+                                        Tag const tag,
+                                        size_t const size){
+                    Message message;
+                    message.header.rebuild(headerSize);
+                    message.writeHeader(msgType, msgID, contextID, srcVAddr, tag);
+                    message.payload.rebuild(size);
+                    message.assembled = true;
+                    return message;
 
                 }
 
                 MsgType getMsgType(){
                     MsgType msgType;
-                    memcpy (&msgType, static_cast<char*>(message.data()), sizeof(MsgType));
+                    memcpy (&msgType, static_cast<char*>(header.data()), sizeof(MsgType));
                     return msgType;
 
                     
@@ -80,45 +170,65 @@ namespace graybat {
 
                 MsgID getMsgID(){
                     MsgID   msgID;
-                    memcpy (&msgID, static_cast<char*>(message.data()) + sizeof(MsgType), sizeof(MsgID));
+                    memcpy (&msgID, static_cast<char*>(header.data()) + sizeof(MsgType), sizeof(MsgID));
                     return msgID;
                     
                 }
 
                 ContextID getContextID(){
                     ContextID contextID;
-                    memcpy (&contextID, static_cast<char*>(message.data()) + sizeof(MsgType) + sizeof(MsgID), sizeof(ContextID));
+                    memcpy (&contextID, static_cast<char*>(header.data()) + sizeof(MsgType) + sizeof(MsgID), sizeof(ContextID));
                     return contextID;
                     
                 }
 
                 VAddr getVAddr(){
                     VAddr vAddr;
-                    memcpy (&vAddr, static_cast<char*>(message.data()) + sizeof(MsgType) + sizeof(MsgID) + sizeof(ContextID), sizeof(VAddr));
+                    memcpy (&vAddr, static_cast<char*>(header.data()) + sizeof(MsgType) + sizeof(MsgID) + sizeof(ContextID), sizeof(VAddr));
                     return vAddr;
 
                 }
 
                 Tag getTag(){
                     Tag tag;
-                    memcpy (&tag, static_cast<char*>(message.data()) + sizeof(MsgType) + sizeof(MsgID) + sizeof(ContextID) + sizeof(VAddr), sizeof(Tag));
+                    memcpy (&tag, static_cast<char*>(header.data()) + sizeof(MsgType) + sizeof(MsgID) + sizeof(ContextID) + sizeof(VAddr), sizeof(Tag));
                     return tag;
 
                 }
 		
 		size_t size() {
-		    return message.size();
+		    return header.size() + payload.size();
 		}
 
                 std::int8_t* getData(){
-                    return static_cast<std::int8_t*>(message.data()) + sizeof(MsgType) + sizeof(MsgID) + sizeof(ContextID) + sizeof(VAddr) + sizeof(Tag);
+                    return static_cast<std::int8_t*>(payload.data());
                     
                 }
                 
-                ::zmq::message_t& getMessage(){
-                    return message;
+                ::zmq::message_t& getHeader(){
+                    return header;
                 }
-                
+
+                ::zmq::message_t& getPayload(){
+                    return payload;
+                }
+
+            private:
+                void writeHeader(MsgType const msgType, MsgID const msgID, ContextID const contextID, VAddr const srcVAddr, Tag const tag){
+                    size_t    msgOffset(0);
+                    memcpy (static_cast<char*>(header.data()) + msgOffset, &msgType,    sizeof(MsgType));   msgOffset += sizeof(MsgType);
+                    memcpy (static_cast<char*>(header.data()) + msgOffset, &msgID,      sizeof(MsgID));     msgOffset += sizeof(MsgID);		
+                    memcpy (static_cast<char*>(header.data()) + msgOffset, &contextID,  sizeof(ContextID)); msgOffset += sizeof(ContextID);
+                    memcpy (static_cast<char*>(header.data()) + msgOffset, &srcVAddr,   sizeof(VAddr));     msgOffset += sizeof(VAddr);
+                    memcpy (static_cast<char*>(header.data()) + msgOffset, &tag,        sizeof(Tag));
+
+                }
+
+                template <typename T_Value>
+                static void destroy(void *, void * hint){
+                    delete static_cast<std::vector<T_Value>*>(hint);
+                }
+
             };
 
             
@@ -0,0 +1,82 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <atomic>  /* std::atomic */
+#include <cstdint> /* std::uint32_t, std::uint64_t */
+
+// ZMQ
+#include <zmq.hpp> /* zmq::message_t */
+
+namespace graybat {
+
+    namespace communicationPolicy {
+
+        namespace zmq {
+
+            /**
+             * @brief Describes which part of a payload a stripe carries.
+             *        It is appended to the message header of every stripe.
+             *
+             */
+            struct StripeInfo {
+                std::uint32_t index;
+                std::uint32_t count;
+                std::uint64_t offset;
+                std::uint64_t size;
+                std::uint64_t total;
+                // Number of the striped message at its sender, the chunks
+                // of one message share their MsgID but not this number
+                std::uint64_t sequence;
+            };
+
+            /**
+             * @brief Keeps the payload of a striped message alive until
+             *        zmq released the frames of all its stripes.
+             *
+             */
+            struct StripeOwner {
+
+                StripeOwner(std::uint32_t const count) :
+                    refs(count){
+
+                }
+
+                // Release function with the signature of zmq_free_fn
+                static void release(void *, void * hint){
+                    StripeOwner * owner = static_cast<StripeOwner*>(hint);
+                    if(--owner->refs == 0){
+                        delete owner;
+                    }
+                }
+
+                ::zmq::message_t payload;
+                std::atomic<std::uint32_t> refs;
+
+            };
+
+        } // zmq
+
+    } // namespace communicationPolicy
+
+} // namespace graybat
@@ -46,7 +46,7 @@ namespace graybat {
 
                 std::vector<VAddr> peersWithSameTag;
                 
-                CommunicationPolicy& comm = cage.comm;
+                CommunicationPolicy& comm = *cage.comm;
                 Context context = comm.getGlobalContext();
                 
 
@@ -0,0 +1,119 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <array>       /* std::array */
+#include <cstddef>     /* std::size_t */
+#include <tuple>       /* std::tuple, std::get */
+#include <type_traits> /* std::integral_constant, std::enable_if */
+#include <utility>     /* std::pair, std::declval, std::index_sequence */
+
+// BOOST
+#include <boost/hana/accessors.hpp>
+#include <boost/hana/concept/struct.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/members.hpp>
+#include <boost/hana/second.hpp>
+#include <boost/hana/tuple.hpp>
+
+namespace utils {
+
+    /**
+     * @brief True for types whose members are known at compile time:
+     *        structs adapted to Boost.Hana, std::tuple and std::pair.
+     */
+    template <typename T>
+    struct IsReflectable : std::integral_constant<bool, boost::hana::Struct<T>::value> {};
+
+    template <typename... T_Members>
+    struct IsReflectable<std::tuple<T_Members...> > : std::true_type {};
+
+    template <typename T_First, typename T_Second>
+    struct IsReflectable<std::pair<T_First, T_Second> > : std::true_type {};
+
+    namespace detail {
+
+        template <bool... T_Values>
+        struct All : std::true_type {};
+
+        template <bool... T_Values>
+        struct All<false, T_Values...> : std::false_type {};
+
+        template <bool... T_Values>
+        struct All<true, T_Values...> : All<T_Values...> {};
+
+        template <typename T_Tuple, typename T_Functor, std::size_t... T_Index>
+        void forEachElement(T_Tuple &tuple, T_Functor &f, std::index_sequence<T_Index...>){
+            using Expand = int[];
+            (void) Expand{0, (f(std::get<T_Index>(tuple)), 0)...};
+        }
+
+    } /* detail */
+
+    /**
+     * @brief Calls *f* with a reference to every member of *object*
+     *        in declaration order.
+     */
+    template <typename... T_Members, typename T_Functor>
+    void forEachMember(std::tuple<T_Members...> &object, T_Functor &&f){
+        detail::forEachElement(object, f, std::index_sequence_for<T_Members...>());
+    }
+
+    template <typename T_First, typename T_Second, typename T_Functor>
+    void forEachMember(std::pair<T_First, T_Second> &object, T_Functor &&f){
+        f(object.first);
+        f(object.second);
+    }
+
+    template <typename T, typename T_Functor>
+    typename std::enable_if<boost::hana::Struct<T>::value>::type
+    forEachMember(T &object, T_Functor &&f){
+        boost::hana::for_each(boost::hana::accessors<T>(), [&object, &f](auto accessor){
+                f(boost::hana::second(accessor)(object));
+            });
+    }
+
+    /**
+     * @brief True for types that can be transmitted as their plain
+     *        object bytes. Reflectable types qualify when all of their
+     *        members do, everything else when it is trivially copyable.
+     */
+    template <typename T, typename T_Enable = void>
+    struct IsRawBytes : std::is_trivially_copyable<T> {};
+
+    template <typename T, std::size_t T_Size>
+    struct IsRawBytes<std::array<T, T_Size> > : IsRawBytes<T> {};
+
+    template <typename... T_Members>
+    struct IsRawBytes<std::tuple<T_Members...> > : detail::All<IsRawBytes<T_Members>::value...> {};
+
+    template <typename T_First, typename T_Second>
+    struct IsRawBytes<std::pair<T_First, T_Second> > : detail::All<IsRawBytes<T_First>::value, IsRawBytes<T_Second>::value> {};
+
+    template <typename... T_Members>
+    struct IsRawBytes<boost::hana::tuple<T_Members...> > : detail::All<IsRawBytes<T_Members>::value...> {};
+
+    template <typename T>
+    struct IsRawBytes<T, typename std::enable_if<boost::hana::Struct<T>::value>::type>
+        : IsRawBytes<decltype(boost::hana::members(std::declval<T>()))> {};
+
+} /* utils */
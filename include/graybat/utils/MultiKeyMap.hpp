@@ -22,13 +22,15 @@
 
 // STL
 #include <map>                /* std::map */
-#include <functional>         /* std::function */
+#include <functional>         /* std::hash */
 #include <condition_variable> /* std::condition_variable */
 #include <mutex>              /* std::mutex, std::lock_guard, std::unique_lock*/
 #include <queue>              /* std::queue */
-#include <utility>            /* std::forward */
-#include <chrono>             /* std::chrono::milliseconds */
+#include <list>               /* std::list */
 #include <atomic>             /* std::atomic */
+#include <array>              /* std::array */
+#include <tuple>              /* std::tuple */
+#include <utility>            /* std::forward */
 
 // BOOST
 #include <boost/optional.hpp>
@@ -112,6 +114,45 @@ namespace utils {
 				>::value
 			>()(t1,t2);
 	}
+
+	/**
+	 *
+	 * @brief Copies the first *length* elements of the tuple src into
+	 *        the tuple dest, the positions pos to end are unrolled
+	 *        at compile time.
+	 *
+	 */
+	template <class T1, class T2, unsigned int pos, unsigned int end>
+	struct PrefixCopy;
+
+	template <class T1, class T2, unsigned int pos>
+	struct PrefixCopy<T1, T2, pos, pos> {
+		void operator()(T1& dest, const T2& src, const size_t length) {
+			boost::ignore_unused(dest, src, length);
+		}
+	};
+
+	template <class T1, class T2, unsigned int pos, unsigned int end>
+	struct PrefixCopy {
+		void operator()(T1& dest, const T2& src, const size_t length) {
+			if(pos < length){
+				std::get<pos>(dest) = std::get<pos>(src);
+				PrefixCopy<T1, T2, pos+1, end>()(dest, src, length);
+			}
+		}
+	};
+
+	/**
+	 * @brief Returns a tuple of type T_Keys which starts with the first
+	 *        *length* elements of *keys* and is value initialized otherwise.
+	 */
+	template <class T_Keys, class... args>
+	T_Keys prefixOf(const std::tuple<args...>& keys, const size_t length = sizeof...(args)) {
+		T_Keys prefix{};
+		PrefixCopy<T_Keys, std::tuple<args...>, 0, sizeof...(args)>()(prefix, keys, length);
+		return prefix;
+	}
+
 	template <typename T_Value, typename... T_Keys>
 	struct MultiKeyMap {
 
@@ -196,162 +237,286 @@ namespace utils {
 
 
 
+	/**
+	 * @brief Combines the std::hash of the elements pos to end of a tuple.
+	 */
+	template <class T, unsigned int pos, unsigned int end>
+	struct TupleHash;
+
+	template <class T, unsigned int pos>
+	struct TupleHash<T, pos, pos> {
+		size_t operator()(const T& t) {
+			boost::ignore_unused(t);
+			return 0;
+		}
+	};
+
+	template <class T, unsigned int pos, unsigned int end>
+	struct TupleHash {
+		size_t operator()(const T& t) {
+			using Element = typename std::tuple_element<pos, T>::type;
+			return std::hash<Element>()(std::get<pos>(t)) + 31 * TupleHash<T, pos+1, end>()(t);
+		}
+	};
+
+	/**
+	 * @brief Thread safe queues of values addressed by keys.
+	 *
+	 * The queues are spread over shards by the hash of their keys. Each
+	 * shard has its own mutex, thus consumers of different keys and the
+	 * producer rarely contend. Every shard counts its values atomically,
+	 * so tryDequeue on an empty shard returns without locking. Waiters
+	 * register at the queue of their key and are woken exactly when a
+	 * value for this key is enqueued. Enqueue blocks while the
+	 * accumulated size of all values would exceed maxBufferSize.
+	 *
+	 * Non-empty queues are additionally listed in a ready index for
+	 * every key prefix, thus a dequeue of any key starting with some
+	 * sub keys looks up one list per shard instead of scanning all
+	 * queues.
+	 *
+	 */
 	template <typename T_Value, typename... T_Keys>
 	struct MessageBox {
 
+		using Keys = std::tuple<T_Keys...>;
+		using Queue = std::queue<T_Value>;
+
+		struct Slot;
+
+		// Non-empty queues in the order they became non-empty
+		using ReadyList = std::list<std::pair<Keys, Slot*> >;
+
+		// Ready lists by prefix length and prefix padded to full keys
+		using ReadyIndex = std::map<std::pair<size_t, Keys>, ReadyList>;
+
+		static constexpr size_t nKeys = sizeof...(T_Keys);
+		static constexpr size_t nShards = 16;
+
+		struct Slot {
+			Queue queue;
+			std::condition_variable condition;
+			size_t waiters = 0;
+			// Position in the ready list of each prefix length, valid while queue is not empty
+			std::array<typename ReadyIndex::iterator, nKeys> readyLists;
+			std::array<typename ReadyList::iterator, nKeys> readyPositions;
+		};
+
+		struct Shard {
+			Shard() :
+				count(0){
+			}
+
+			std::mutex access;
+			std::atomic<size_t> count;
+			MultiKeyMap<Slot, T_Keys...> multiKeyMap;
+			ReadyIndex readyIndex;
+		};
+
 		MessageBox(size_t const maxBufferSize) :
 				maxBufferSize(maxBufferSize),
-				bufferSize(0){
+				bufferSize(0),
+				anyWaiters(0),
+				spaceWaiters(0),
+				generation(0),
+				nextShard(0){
 		}
 
 		size_t maxBufferSize;
 		std::atomic<size_t> bufferSize;
-		std::mutex access;
-		std::mutex writeNotify;
-		std::mutex readNotify;
-		std::condition_variable writeCondition;
-		std::condition_variable readCondition;
+		std::array<Shard, nShards> shards;
 
-		using Queue = std::queue<T_Value>;
-		MultiKeyMap<Queue, T_Keys...> multiKeyMap;
+		// Waiters for any key and writers waiting for free space
+		std::mutex notifyAccess;
+		std::condition_variable anyCondition;
+		std::condition_variable spaceCondition;
+		std::atomic<size_t> anyWaiters;
+		std::atomic<size_t> spaceWaiters;
+		size_t generation;
+		std::atomic<size_t> nextShard;
 
 		auto enqueue(T_Value&& value, const T_Keys... keys) -> void {
+			Keys const keysTuple = std::make_tuple(keys...);
+			reserve(value.size());
+
+			Shard &shard = shardOf(keysTuple);
 			{
-				while(maxBufferSize < bufferSize + value.size()){
-					std::unique_lock<std::mutex> notifyLock(readNotify);
-					readCondition.wait_for(notifyLock, std::chrono::milliseconds(100));
+				std::lock_guard<std::mutex> accessLock(shard.access);
+				Slot &slot = shard.multiKeyMap(keys...);
+				if(slot.queue.empty()){
+					markReady(shard, slot, keysTuple);
 				}
+				slot.queue.push(std::forward<T_Value>(value));
+				shard.count++;
 
-				bufferSize += value.size();
-				//std::cout << bufferSize << std::endl;
-				//std::cout << "Try to enqueue message." << std::endl;
-				std::lock_guard<std::mutex> accessLock(access);
-				multiKeyMap(keys...).push(std::forward<T_Value>(value));
+				if(slot.waiters > 0){
+					slot.condition.notify_one();
+				}
 			}
-			//std::cout << "notify on condition variable." << std::endl;
-			writeCondition.notify_one();
-		}
 
-		auto waitDequeue(const T_Keys... keys) -> T_Value {
-
-			bool test = false;
-
-			{
-				std::lock_guard<std::mutex> accessLock(access);
-				test = !multiKeyMap.test(keys...);
+			if(anyWaiters > 0){
+				std::lock_guard<std::mutex> notifyLock(notifyAccess);
+				generation++;
+				anyCondition.notify_all();
 			}
 
-			while(test){
-				std::unique_lock<std::mutex> notifyLock(writeNotify);
-				//std::cout << "wait for multikeymap enqueue." << std::endl;
-				writeCondition.wait_for(notifyLock, std::chrono::milliseconds(100));
-				{
-					std::lock_guard<std::mutex> accessLock(access);
-					test = !multiKeyMap.test(keys...);
-				}
+		}
 
-			}
+		auto waitDequeue(const T_Keys... keys) -> T_Value {
+			Keys const keysTuple = std::make_tuple(keys...);
+			Shard &shard = shardOf(keysTuple);
 
-			while([&](){
-                //The access of "multiKeyMap.at(keys...)" is a critical section
-                bool empty = true;
-                {
-                    std::lock_guard<std::mutex> accessLock(access);
-                    empty = multiKeyMap.at(keys...).empty();
-                }
-                return empty;
-            }()){
-				std::unique_lock<std::mutex> notifyLock(writeNotify);
-				//std::cout << "wait for queue to be filled." << std::endl;
-				writeCondition.wait_for(notifyLock, std::chrono::milliseconds(100));
+			std::unique_lock<std::mutex> accessLock(shard.access);
+			Slot &slot = shard.multiKeyMap(keys...);
 
-			}
+			slot.waiters++;
+			slot.condition.wait(accessLock, [&slot]{ return !slot.queue.empty(); });
+			slot.waiters--;
 
-			{
-				std::lock_guard<std::mutex> accessLock(access);
-				//std::cout << "get message from queue" << std::endl;
-				T_Value value = std::move(multiKeyMap.at(keys...).front());
-				multiKeyMap.at(keys...).pop();
-				bufferSize -= value.size();
-				readCondition.notify_one();
-				return value;
-			}
+			return pop(shard, slot, keysTuple);
 
 		}
 
 		template <typename... SubKeys>
 		auto waitDequeue(std::tuple<T_Keys...> &allKeys, const SubKeys... someKeys) -> T_Value {
+			static_assert(sizeof...(SubKeys) < nKeys, "Use waitDequeue(keys...) to dequeue by all keys.");
 
-			while(true){
+			auto const indexKey = std::make_pair(sizeof...(SubKeys), prefixOf<Keys>(std::make_tuple(someKeys...)));
 
-				std::vector<std::reference_wrapper<Queue>> values;
-				std::vector<std::tuple<T_Keys...> > keysList;
-				while(values.empty()){
-					std::unique_lock<std::mutex> notifyLock(writeNotify);
-					{
-						std::lock_guard<std::mutex> accessLock(access);
-						multiKeyMap.values(values, keysList, someKeys...);
+			// Registered before the scan, thus every later enqueue bumps the generation
+			anyWaiters++;
 
-					}
-					writeCondition.wait_for(notifyLock, std::chrono::milliseconds(100));
+			while(true){
+				size_t seenGeneration = 0;
+				{
+					std::lock_guard<std::mutex> notifyLock(notifyAccess);
+					seenGeneration = generation;
 				}
 
-				{
-					std::lock_guard<std::mutex> accessLock(access);
-					for(auto &keys : keysList ){
-						auto& queue = multiKeyMap.at(keys);
-						if(!queue.empty()) {
-							allKeys = keys;
-							T_Value value = std::move(queue.front());
-							queue.pop();
-							bufferSize -= value.size();
-							readCondition.notify_one();
-							return value;
-						}
+				// Start at another shard each time, thus no shard is preferred
+				size_t const first = nextShard++;
+				for(size_t shard_i = 0; shard_i < nShards; ++shard_i){
+					Shard &shard = shards[(first + shard_i) % nShards];
+					if(shard.count == 0){
+						continue;
+					}
 
+					std::lock_guard<std::mutex> accessLock(shard.access);
+					auto ready = shard.readyIndex.find(indexKey);
+					if(ready != shard.readyIndex.end()){
+						anyWaiters--;
+						// Ready lists are dropped when empty, copy the keys before pop
+						allKeys = ready->second.front().first;
+						return pop(shard, *ready->second.front().second, allKeys);
 					}
 				}
-				std::unique_lock<std::mutex> notifyLock(writeNotify);
-				writeCondition.wait_for(notifyLock, std::chrono::milliseconds(100));
+
+				std::unique_lock<std::mutex> notifyLock(notifyAccess);
+				anyCondition.wait(notifyLock, [this, seenGeneration]{ return generation != seenGeneration; });
 
 			}
 
 		}
 
 		auto tryDequeue(bool &result, const T_Keys... keys) -> T_Value {
+			Keys const keysTuple = std::make_tuple(keys...);
+			Shard &shard = shardOf(keysTuple);
 
-			{
-				std::lock_guard<std::mutex> accessLock(access);
-				if(!multiKeyMap.test(keys...)){
-					result = false;
-					return T_Value();
-				}
+			// Lock free fast path for empty shards
+			if(shard.count == 0){
+				result = false;
+				return T_Value();
 			}
 
-			if(multiKeyMap.at(keys...).empty()){
+			std::lock_guard<std::mutex> accessLock(shard.access);
+			if(!shard.multiKeyMap.test(keys...) || shard.multiKeyMap.at(keys...).queue.empty()){
 				result = false;
 				return T_Value();
 			}
 
-			// //while(test){
-			//     std::unique_lock<std::mutex> notifyLock(writeNotify);
-			//     //std::cout << "wait for multikeymap enqueue." << std::endl;
-			//     writeCondition.wait_for(notifyLock, std::chrono::milliseconds(100));
-			//     {
-			//         std::lock_guard<std::mutex> accessLock(access);
-			//         test = !multiKeyMap.test(keys...);
-			//     }
-			//     //}
+			result = true;
+			return pop(shard, shard.multiKeyMap.at(keys...), keysTuple);
 
-			{
-				std::lock_guard<std::mutex> accessLock(access);
-				//std::cout << "get message from queue" << std::endl;
-				T_Value value = std::move(multiKeyMap.at(keys...).front());
-				multiKeyMap.at(keys...).pop();
-				bufferSize -= value.size();
-				readCondition.notify_one();
-				result = true;
-				return value;
+		}
+
+	private:
+		auto shardOf(Keys const &keysTuple) -> Shard& {
+			return shards[TupleHash<Keys, 0, nKeys>()(keysTuple) % nShards];
+		}
+
+		/**
+		 * @brief Books *size* bytes of the buffer, waits while they
+		 *        do not fit. A value larger than the buffer is accepted
+		 *        when the buffer is empty.
+		 */
+		auto reserve(size_t const size) -> void {
+			size_t current = bufferSize;
+			while(true){
+				if(current == 0 || current + size <= maxBufferSize){
+					if(bufferSize.compare_exchange_weak(current, current + size)){
+						return;
+					}
+					continue;
+				}
+
+				std::unique_lock<std::mutex> notifyLock(notifyAccess);
+				spaceWaiters++;
+				spaceCondition.wait(notifyLock, [this, size, &current]{
+					current = bufferSize;
+					return current == 0 || current + size <= maxBufferSize;
+				});
+				spaceWaiters--;
+			}
+
+		}
+
+		/**
+		 * @brief Takes the front value of *slot* and drops the slot
+		 *        when nobody uses it anymore.
+		 *
+		 * @remark The caller holds the access mutex of *shard*.
+		 */
+		auto pop(Shard &shard, Slot &slot, Keys const keysTuple) -> T_Value {
+			T_Value value = std::move(slot.queue.front());
+			slot.queue.pop();
+			shard.count--;
+
+			if(slot.queue.empty()){
+				unmarkReady(shard, slot);
+				if(slot.waiters == 0){
+					shard.multiKeyMap.multiKeyMap.erase(keysTuple);
+				}
+			}
+
+			bufferSize -= value.size();
+			if(spaceWaiters > 0){
+				std::lock_guard<std::mutex> notifyLock(notifyAccess);
+				spaceCondition.notify_all();
+			}
+
+			return value;
+
+		}
+
+		/**
+		 * @brief Appends *slot* to the ready list of each prefix of *keysTuple*.
+		 */
+		auto markReady(Shard &shard, Slot &slot, Keys const &keysTuple) -> void {
+			for(size_t length = 0; length < nKeys; ++length){
+				auto ready = shard.readyIndex.emplace(std::make_pair(length, prefixOf<Keys>(keysTuple, length)), ReadyList()).first;
+				slot.readyLists[length]     = ready;
+				slot.readyPositions[length] = ready->second.insert(ready->second.end(), std::make_pair(keysTuple, &slot));
+			}
+
+		}
+
+		auto unmarkReady(Shard &shard, Slot &slot) -> void {
+			for(size_t length = 0; length < nKeys; ++length){
+				auto ready = slot.readyLists[length];
+				ready->second.erase(slot.readyPositions[length]);
+				if(ready->second.empty()){
+					shard.readyIndex.erase(ready);
+				}
 			}
 
 		}
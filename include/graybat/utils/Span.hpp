@@ -0,0 +1,80 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef>     /* std::size_t */
+#include <type_traits> /* std::remove_cv, std::remove_pointer */
+
+namespace utils {
+
+    /**
+     * @brief Non owning view on *size* contiguous elements.
+     *
+     * Provides the data(), size() interface of the communication
+     * policies, thus a slice of a larger buffer can be send or
+     * received in place.
+     */
+    template <typename T>
+    struct Span {
+        using value_type = typename std::remove_cv<T>::type;
+
+        Span(T * const data, std::size_t const size) :
+            ptr(data),
+            n(size){
+
+        }
+
+        T* data() const {
+            return ptr;
+        }
+
+        std::size_t size() const {
+            return n;
+        }
+
+        T* begin() const {
+            return ptr;
+        }
+
+        T* end() const {
+            return ptr + n;
+        }
+
+        T& operator[](std::size_t const i) const {
+            return ptr[i];
+        }
+
+    private:
+        T * ptr;
+        std::size_t n;
+    };
+
+    /**
+     * @brief Returns a view on the elements [first, first + size) of *data*.
+     */
+    template <typename T_Data>
+    auto makeSpan(T_Data & data, std::size_t const first, std::size_t const size)
+        -> Span<typename std::remove_pointer<decltype(data.data())>::type> {
+        return Span<typename std::remove_pointer<decltype(data.data())>::type>(data.data() + first, size);
+    }
+    
+} /* utils */
@@ -19,12 +19,14 @@
  */
 
 // STL
+#include <algorithm>  /* std::fill */
 #include <array>
 #include <vector>
 #include <iostream>   /* std::cout, std::endl */
 #include <functional> /* std::plus, std::ref */
 #include <cstdlib>    /* std::getenv */
 #include <string>     /* std::string, std::stoi */
+#include <thread>     /* std::thread */
 
 // BOOST
 #include <boost/test/unit_test.hpp>
@@ -40,6 +42,8 @@
 #include <graybat/Cage.hpp>
 #include <graybat/communicationPolicy/BMPI.hpp>
 #include <graybat/communicationPolicy/ZMQ.hpp>
+#include <graybat/communicationPolicy/SHM.hpp>
+#include <graybat/communicationPolicy/Threads.hpp>
 #include <graybat/graphPolicy/BGL.hpp>
 #include <graybat/mapping/Random.hpp>
 #include <graybat/mapping/Consecutive.hpp>
@@ -105,24 +109,33 @@ BOOST_AUTO_TEST_SUITE( graybat_cage_point_to_point_test )
 
     using ZMQ        = graybat::communicationPolicy::ZMQ;
     using BMPI       = graybat::communicationPolicy::BMPI;
+    using SHM        = graybat::communicationPolicy::SHM;
     using GP         = graybat::graphPolicy::BGL<>;
     using ZMQCage    = graybat::Cage<ZMQ, GP>;
     using BMPICage   = graybat::Cage<BMPI, GP>;
+    using SHMCage    = graybat::Cage<SHM, GP>;
     using ZMQConfig  = ZMQ::Config;
     using BMPIConfig = BMPI::Config;
+    using SHMConfig  = SHM::Config;
 
     ZMQConfig zmqConfig = {"tcp://127.0.0.1:5000",
                            "tcp://127.0.0.1:5001",
                            static_cast<size_t>(std::stoi(std::getenv("OMPI_COMM_WORLD_SIZE"))),
                            "context_cage_test"};
 
-    BMPIConfig bmpiConfig;
+    BMPIConfig bmpiConfig = {boost::mpi::threading::multiple};
+
+    SHMConfig shmConfig = {"tcp://127.0.0.1:5000",
+                           static_cast<size_t>(std::stoi(std::getenv("OMPI_COMM_WORLD_SIZE"))),
+                           "context_shm_cage_test"};
 
     ZMQCage zmqCage(zmqConfig);
     BMPICage bmpiCage(bmpiConfig);
+    SHMCage shmCage(shmConfig);
 
     auto cages = hana::make_tuple(std::ref(zmqCage),
-                                  std::ref(bmpiCage) );
+                                  std::ref(bmpiCage),
+                                  std::ref(shmCage) );
 
 //    auto cages = hana::make_tuple(std::ref(zmqCage));
 
@@ -433,6 +446,359 @@ BOOST_AUTO_TEST_CASE( asyncSend_recv ){
 
 }
 
+    BOOST_AUTO_TEST_CASE( thread_peers ){
+        // Test setup
+        using Threads = graybat::communicationPolicy::Threads;
+        using Cage    = graybat::Cage<Threads, GP>;
+        using Event   = typename Cage::Event;
+        using Vertex  = typename Cage::Vertex;
+        using Edge    = typename Cage::Edge;
+
+        const unsigned nThreads  = 4;
+        const unsigned nElements = 1000;
+
+        // Test run
+        std::vector<unsigned> nErrors(nThreads, 0);
+        std::vector<std::thread> threads;
+
+        for(unsigned thread_i = 0; thread_i < nThreads; ++thread_i){
+            threads.emplace_back([&nErrors, thread_i, nThreads, nElements](){
+                    Cage cage(Threads::Config({nThreads, "context_threads_cage_test"}));
+                    cage.setGraph(graybat::pattern::FullyConnected<GP>(nThreads * 2));
+                    cage.distribute(graybat::mapping::Roundrobin());
+
+                    for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+                        std::vector<Event> events;
+                        std::vector<unsigned> send(nElements, run_i);
+                        std::vector<unsigned> recv(nElements, 0);
+
+                        for(Vertex &v : cage.hostedVertices){
+                            for(Edge edge : cage.getOutEdges(v)){
+                                cage.send(edge, send, events);
+                            }
+                        }
+
+                        for(Vertex &v : cage.hostedVertices){
+                            for(Edge edge : cage.getInEdges(v)){
+                                cage.recv(edge, recv);
+                                for(unsigned i = 0; i < recv.size(); ++i){
+                                    nErrors.at(thread_i) += recv.at(i) != run_i;
+                                }
+                            }
+                        }
+
+                        for(Event &e : events){
+                            e.wait();
+                        }
+
+                    }
+
+                });
+        }
+
+        for(std::thread &thread : threads){
+            thread.join();
+        }
+
+        for(unsigned errors : nErrors){
+            BOOST_CHECK_EQUAL(errors, 0);
+        }
+
+    }
+
+    BOOST_AUTO_TEST_CASE( persistent_channels ){
+        // Test setup
+        using Cage     = BMPICage;
+        using Channels = typename BMPI::Channels;
+        using Vertex   = typename Cage::Vertex;
+        using Edge     = typename Cage::Edge;
+
+        const unsigned nElements = 1000;
+
+        bmpiCage.setGraph(graybat::pattern::FullyConnected<GP>(bmpiCage.getPeers().size()));
+        bmpiCage.distribute(graybat::mapping::Roundrobin());
+
+        // Buffers have to stay in place as long as the channels exist
+        std::vector<unsigned> send(nElements, 0);
+        std::vector<std::vector<unsigned>> recvs;
+        for(Vertex &v : bmpiCage.hostedVertices){
+            recvs.resize(recvs.size() + bmpiCage.getInEdges(v).size(), std::vector<unsigned>(nElements, 0));
+        }
+
+        Channels channels;
+        unsigned recv_i = 0;
+        for(Vertex &v : bmpiCage.hostedVertices){
+            bmpiCage.spreadInit(v, send, channels);
+            for(Edge edge : bmpiCage.getInEdges(v)){
+                bmpiCage.recvInit(edge, recvs.at(recv_i++), channels);
+            }
+        }
+
+        // Test run
+        for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+            std::fill(send.begin(), send.end(), run_i);
+
+            channels.start();
+            channels.wait();
+
+            for(std::vector<unsigned> &recv : recvs){
+                for(unsigned i = 0; i < recv.size(); ++i){
+                    BOOST_REQUIRE_EQUAL(recv.at(i), run_i);
+                }
+            }
+
+        }
+
+    }
+
+    BOOST_AUTO_TEST_CASE( neighborhood_exchange ){
+        // Test setup
+        using Cage         = BMPICage;
+        using Neighborhood = typename Cage::Neighborhood;
+        using Vertex       = typename Cage::Vertex;
+        using Edge         = typename Cage::Edge;
+
+        const unsigned nElements = 100;
+
+        bmpiCage.setGraph(graybat::pattern::FullyConnected<GP>(bmpiCage.getPeers().size() * 2));
+        bmpiCage.distribute(graybat::mapping::Roundrobin());
+
+        Neighborhood neighborhood = bmpiCage.createNeighborhood();
+
+        unsigned nInEdges = 0;
+        for(Vertex &v : bmpiCage.hostedVertices){
+            nInEdges += bmpiCage.getInEdges(v).size();
+        }
+
+        std::vector<unsigned> send(bmpiCage.hostedVertices.size() * nElements);
+        std::vector<unsigned> recv(nInEdges * nElements);
+
+        // Test run
+        for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+            for(unsigned vertex_i = 0; vertex_i < bmpiCage.hostedVertices.size(); ++vertex_i){
+                std::fill(send.begin() + vertex_i * nElements,
+                          send.begin() + (vertex_i + 1) * nElements,
+                          bmpiCage.hostedVertices[vertex_i].id + run_i);
+            }
+
+            if(run_i % 2){
+                bmpiCage.asyncExchange(neighborhood, send, recv);
+
+                // A running exchange may be moved
+                Neighborhood moved(std::move(neighborhood));
+                moved.wait();
+                neighborhood = std::move(moved);
+            }
+            else {
+                bmpiCage.exchange(neighborhood, send, recv);
+            }
+
+            unsigned slot_i = 0;
+            for(Vertex &v : bmpiCage.hostedVertices){
+                for(Edge edge : bmpiCage.getInEdges(v)){
+                    for(unsigned i = 0; i < nElements; ++i){
+                        BOOST_REQUIRE_EQUAL(recv.at(slot_i * nElements + i), edge.source.id + run_i);
+                    }
+                    ++slot_i;
+                }
+            }
+
+        }
+
+    }
+
+    BOOST_AUTO_TEST_CASE( window_send_recv ){
+        // Test setup
+        using Cage   = BMPICage;
+        using Window = typename Cage::Window;
+        using Vertex = typename Cage::Vertex;
+        using Edge   = typename Cage::Edge;
+
+        const unsigned nElements = 100;
+
+        bmpiCage.setGraph(graybat::pattern::FullyConnected<GP>(bmpiCage.getPeers().size() * 2));
+        bmpiCage.distribute(graybat::mapping::Roundrobin());
+
+        // One window is synchronized by fences, the other by PSCW epochs
+        Window fenced = bmpiCage.createWindow<unsigned>(nElements);
+        Window scoped = bmpiCage.createWindow<unsigned>(nElements);
+
+        std::vector<std::vector<unsigned>> sends(bmpiCage.hostedVertices.size(), std::vector<unsigned>(nElements));
+        std::vector<unsigned> recv(nElements);
+
+        // Test run
+        for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+            Window &window = run_i % 2 ? scoped : fenced;
+
+            if(run_i % 2){
+                bmpiCage.openEpoch(window);
+            }
+            else {
+                bmpiCage.fence(window);
+            }
+
+            for(unsigned vertex_i = 0; vertex_i < bmpiCage.hostedVertices.size(); ++vertex_i){
+                Vertex &v = bmpiCage.hostedVertices[vertex_i];
+                std::fill(sends[vertex_i].begin(), sends[vertex_i].end(), v.id + run_i);
+                for(Edge edge : bmpiCage.getOutEdges(v)){
+                    bmpiCage.send(edge, sends[vertex_i], window);
+                }
+            }
+
+            if(run_i % 2){
+                bmpiCage.closeEpoch(window);
+            }
+            else {
+                bmpiCage.fence(window);
+            }
+
+            for(Vertex &v : bmpiCage.hostedVertices){
+                for(Edge edge : bmpiCage.getInEdges(v)){
+                    bmpiCage.recv(edge, recv, window);
+                    for(unsigned i = 0; i < nElements; ++i){
+                        BOOST_REQUIRE_EQUAL(recv.at(i), edge.source.id + run_i);
+                    }
+                }
+            }
+
+        }
+
+    }
+
+    BOOST_AUTO_TEST_CASE( concurrent_vertices ){
+        // Test setup
+        using Cage   = BMPICage;
+        using Event  = typename Cage::Event;
+        using Vertex = typename Cage::Vertex;
+        using Edge   = typename Cage::Edge;
+
+        const unsigned nElements = 1000;
+        const unsigned nRunsPerVertex = 100;
+
+        bmpiCage.setGraph(graybat::pattern::FullyConnected<GP>(bmpiCage.getPeers().size() * 4));
+        bmpiCage.distribute(graybat::mapping::Roundrobin());
+
+        const unsigned nVertices = bmpiCage.getVertices().size();
+        const unsigned nHosted   = bmpiCage.hostedVertices.size();
+
+        // Test run: every hosted vertex is driven by its own thread
+        std::vector<unsigned> nErrors(nHosted, 0);
+        std::vector<std::vector<unsigned>> sums(nHosted, std::vector<unsigned>(1, 0));
+        std::vector<std::thread> threads;
+
+        for(unsigned vertex_i = 0; vertex_i < nHosted; ++vertex_i){
+            threads.emplace_back([&nErrors, &sums, vertex_i, nElements, nRunsPerVertex](){
+                    Vertex v = bmpiCage.hostedVertices.at(vertex_i);
+
+                    for(unsigned run_i = 0; run_i < nRunsPerVertex; ++run_i){
+                        std::vector<Event> events;
+                        std::vector<unsigned> send(nElements, v.id + run_i);
+                        std::vector<unsigned> recv(nElements, 0);
+
+                        for(Edge edge : bmpiCage.getOutEdges(v)){
+                            bmpiCage.send(edge, send, events);
+                        }
+
+                        for(Edge edge : bmpiCage.getInEdges(v)){
+                            bmpiCage.recv(edge, recv);
+                            for(unsigned i = 0; i < recv.size(); ++i){
+                                nErrors.at(vertex_i) += recv.at(i) != edge.source.id + run_i;
+                            }
+                        }
+
+                        for(Event &e : events){
+                            e.wait();
+                        }
+
+                    }
+
+                    bmpiCage.allReduce(v, std::plus<unsigned>(), std::vector<unsigned>(1, 1), sums.at(vertex_i));
+
+                });
+        }
+
+        for(std::thread &thread : threads){
+            thread.join();
+        }
+
+        for(unsigned vertex_i = 0; vertex_i < nHosted; ++vertex_i){
+            BOOST_CHECK_EQUAL(nErrors.at(vertex_i), 0);
+            BOOST_CHECK_EQUAL(sums.at(vertex_i).at(0), nVertices);
+        }
+
+    }
+
+    BOOST_AUTO_TEST_CASE( split_barrier ){
+        hana::for_each(cages, [](auto cageRef){
+                // Test setup
+                using Cage    = typename decltype(cageRef)::type;
+                using GP      = typename Cage::GraphPolicy;
+                using Barrier = typename Cage::Barrier;
+
+                auto& cage = cageRef.get();
+                cage.setGraph(graybat::pattern::FullyConnected<GP>(cage.getPeers().size()));
+                cage.distribute(graybat::mapping::Roundrobin());
+
+                // Test run
+                for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+                    Barrier barrier = cage.arrive();
+
+                    // Local work until all peers arrived
+                    unsigned nLocalSteps = 0;
+                    while(!barrier.ready()){
+                        nLocalSteps++;
+                    }
+                    barrier.wait();
+
+                    cage.synchronize();
+
+                }
+
+            });
+
+    }
+
+    BOOST_AUTO_TEST_CASE( reduce_scatter ){
+        hana::for_each(cages, [](auto cageRef){
+                // Test setup
+                using Cage   = typename decltype(cageRef)::type;
+                using GP     = typename Cage::GraphPolicy;
+
+                const unsigned nElements = 10;
+
+                auto& cage = cageRef.get();
+                cage.setGraph(graybat::pattern::FullyConnected<GP>(cage.getPeers().size() * 3));
+                cage.distribute(graybat::mapping::Roundrobin());
+
+                const unsigned nVertices = cage.getVertices().size();
+
+                // Test run
+                for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+                    std::vector<std::vector<unsigned>> recvs(cage.hostedVertices.size(), std::vector<unsigned>(nElements, 0));
+
+                    // Block k of vertex v contains v.id + k
+                    for(unsigned vertex_i = 0; vertex_i < cage.hostedVertices.size(); ++vertex_i){
+                        auto v = cage.hostedVertices[vertex_i];
+                        std::vector<unsigned> send(nElements * nVertices);
+                        for(unsigned i = 0; i < send.size(); ++i){
+                            send[i] = v.id + i / nElements + run_i;
+                        }
+                        cage.reduceScatter(v, std::plus<unsigned>(), send, recvs[vertex_i]);
+                    }
+
+                    for(unsigned vertex_i = 0; vertex_i < cage.hostedVertices.size(); ++vertex_i){
+                        const unsigned id = cage.hostedVertices[vertex_i].id;
+                        for(unsigned d : recvs[vertex_i]){
+                            BOOST_REQUIRE_EQUAL(d, nVertices * (nVertices - 1) / 2 + nVertices * (id + run_i));
+                        }
+                    }
+
+                }
+
+            });
+
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE( graybat_cage_collective_test )
@@ -24,6 +24,9 @@
 
 // STL
 #include <iostream>   /* std::cout, std::endl */
+#include <thread>     /* std::thread */
+#include <numeric>    /* std::iota, std::accumulate */
+#include <atomic>     /* std::atomic */
 
 // ELEGANT-PROGRESSBARS
 #include <elegant-progressbars/policyProgressbar.hpp>
@@ -33,10 +36,26 @@
 #include <graybat/Cage.hpp>
 #include <graybat/communicationPolicy/ZMQ.hpp>
 #include <graybat/communicationPolicy/BMPI.hpp>
+#include <graybat/communicationPolicy/SHM.hpp>
+#include <graybat/communicationPolicy/Threads.hpp>
 
 // HANA
 
 #include <boost/hana/for_each.hpp>
+#include <boost/hana/define_struct.hpp>
+
+/*******************************************************************************
+ * Structured Types
+ ******************************************************************************/
+struct Particle {
+    BOOST_HANA_DEFINE_STRUCT(Particle,
+                             (double, x),
+                             (unsigned, id),
+                             (char, kind));
+};
+
+GRAYBAT_MPI_DATATYPE(Particle)
+GRAYBAT_MPI_DATATYPE(std::tuple<unsigned, double>)
 
 /*******************************************************************************
  * Communication Policies to Test
@@ -47,21 +66,29 @@ size_t const nRuns = 1000;
 
 using ZMQ        = graybat::communicationPolicy::ZMQ;
 using BMPI       = graybat::communicationPolicy::BMPI;
+using SHM        = graybat::communicationPolicy::SHM;
 using ZMQConfig  = ZMQ::Config;
 using BMPIConfig = BMPI::Config;
+using SHMConfig  = SHM::Config;
 
 ZMQConfig zmqConfig = {"tcp://127.0.0.1:5000",
                        "tcp://127.0.0.1:5001",
                        static_cast<size_t>(std::stoi(std::getenv("OMPI_COMM_WORLD_SIZE"))),
                        "context_cp_test"};
 
-BMPIConfig bmpiConfig;
+BMPIConfig bmpiConfig = {boost::mpi::threading::multiple};
+
+SHMConfig shmConfig = {"tcp://127.0.0.1:5000",
+                       static_cast<size_t>(std::stoi(std::getenv("OMPI_COMM_WORLD_SIZE"))),
+                       "context_shm_cp_test"};
 
 ZMQ zmqCP(zmqConfig);
 BMPI bmpiCP(bmpiConfig);
+SHM shmCP(shmConfig);
 
 auto communicationPolicies = hana::make_tuple(std::ref(zmqCP),
-                                              std::ref(bmpiCP) );
+                                              std::ref(bmpiCP),
+                                              std::ref(shmCP) );
 
 
 /*******************************************************************************
@@ -299,6 +326,346 @@ BOOST_AUTO_TEST_CASE( async_send_recv){
 }
 
 
+BOOST_AUTO_TEST_CASE( zero_copy_send_recv ){
+    // Test setup
+    ZMQConfig zeroCopyConfig = zmqConfig;
+    zeroCopyConfig.contextName = "context_cp_zero_copy_test";
+    zeroCopyConfig.zeroCopy    = true;
+    ZMQ cp(zeroCopyConfig);
+    Progress progress(cp);
+
+    // Test run
+    {
+        const unsigned nElements = 100000;
+        const unsigned tag = 99;
+
+        ZMQ::Context context = cp.getGlobalContext();
+
+        for(unsigned run_i = 0; run_i < nRuns / 100; ++run_i){
+            std::vector<ZMQ::Event> events;
+            std::vector<unsigned> data (nElements, 0);
+            std::iota(data.begin(), data.end(), context.getVAddr());
+
+            for(auto const &vAddr : context){
+                // Send from the buffer of data and from a moved in copy of data
+                events.push_back(cp.asyncSend(vAddr, tag, context, data));
+                events.push_back(cp.asyncSend(vAddr, tag, context, std::vector<unsigned>(data)));
+
+            }
+
+            for(auto const &vAddr : context){
+                for(unsigned msg_i = 0; msg_i < 2; ++msg_i){
+                    std::vector<unsigned> recv (nElements, 0);
+                    cp.recv(vAddr, tag, context, recv);
+
+                    for(unsigned i = 0; i < recv.size(); ++i){
+                        BOOST_REQUIRE_EQUAL(recv[i], vAddr + i);
+                    }
+
+                }
+
+            }
+
+            for(ZMQ::Event &e : events){
+                e.wait();
+            }
+
+            progress.print(nRuns / 100, run_i);
+
+        }
+
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE( credit_flow_control ){
+    // Test setup
+    ZMQConfig creditConfig = zmqConfig;
+    creditConfig.contextName = "context_cp_credit_test";
+    creditConfig.credits     = 2;
+    creditConfig.coalesceSize = 0;
+    ZMQ cp(creditConfig);
+
+    // Test run, more messages in flight than credits
+    {
+        const unsigned nMessages = 100;
+        const unsigned tag = 98;
+
+        ZMQ::Context context = cp.getGlobalContext();
+
+        std::vector<ZMQ::Event> events;
+        for(auto const &vAddr : context){
+            for(unsigned msg_i = 0; msg_i < nMessages; ++msg_i){
+                std::vector<unsigned> data (1, msg_i);
+                events.push_back(cp.asyncSend(vAddr, tag, context, data));
+            }
+        }
+
+        for(auto const &vAddr : context){
+            for(unsigned msg_i = 0; msg_i < nMessages; ++msg_i){
+                std::vector<unsigned> recv (1, 0);
+                cp.recv(vAddr, tag, context, recv);
+                BOOST_REQUIRE_EQUAL(recv[0], msg_i);
+            }
+        }
+
+        for(ZMQ::Event &e : events){
+            e.wait();
+        }
+
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE( coalesced_send_recv ){
+    // Test setup
+    ZMQConfig coalesceConfig = zmqConfig;
+    coalesceConfig.contextName       = "context_cp_coalesce_test";
+    coalesceConfig.credits           = 2;
+    coalesceConfig.coalesceSize      = 256;
+    coalesceConfig.coalesceThreshold = 16;
+    ZMQ cp(coalesceConfig);
+
+    // Test run, coalesced and not coalesced messages have to keep their order
+    {
+        const unsigned nMessages = 100;
+        const unsigned tag = 95;
+
+        ZMQ::Context context = cp.getGlobalContext();
+
+        std::vector<ZMQ::Event> events;
+        for(auto const &vAddr : context){
+            for(unsigned msg_i = 0; msg_i < nMessages; ++msg_i){
+                std::vector<unsigned> data (msg_i % 10 == 0 ? 100 : 1, msg_i);
+                events.push_back(cp.asyncSend(vAddr, tag, context, data));
+            }
+        }
+
+        for(auto const &vAddr : context){
+            for(unsigned msg_i = 0; msg_i < nMessages; ++msg_i){
+                std::vector<unsigned> recv (msg_i % 10 == 0 ? 100 : 1, 0);
+                cp.recv(vAddr, tag, context, recv);
+                BOOST_REQUIRE_EQUAL(recv.front(), msg_i);
+                BOOST_REQUIRE_EQUAL(recv.back(), msg_i);
+            }
+        }
+
+        for(ZMQ::Event &e : events){
+            e.wait();
+        }
+
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE( wait_strategies ){
+    // Test setup
+    ZMQConfig waitConfig = zmqConfig;
+    waitConfig.contextName = "context_cp_wait_test";
+    ZMQ cp(waitConfig);
+
+    // Test run, every strategy waits until the data arrived
+    {
+        const unsigned tag = 94;
+        ZMQ::Context context = cp.getGlobalContext();
+
+        std::vector<graybat::communicationPolicy::socket::WaitMode> modes {{ graybat::communicationPolicy::socket::WaitMode::BLOCK,
+                                                                             graybat::communicationPolicy::socket::WaitMode::ADAPTIVE,
+                                                                             graybat::communicationPolicy::socket::WaitMode::SPIN }};
+
+        for(auto const mode : modes){
+            graybat::communicationPolicy::socket::WaitStrategy strategy;
+            strategy.mode = mode;
+
+            std::vector<ZMQ::Event> sendEvents;
+            std::vector<ZMQ::Event> recvEvents;
+            std::vector<std::vector<unsigned> > recv (context.size(), std::vector<unsigned>(1, 0));
+
+            for(auto const &vAddr : context){
+                recvEvents.push_back(cp.asyncRecv(vAddr, tag, context, recv[vAddr]));
+            }
+
+            for(auto const &vAddr : context){
+                std::vector<unsigned> data (1, context.getVAddr() + static_cast<unsigned>(mode));
+                sendEvents.push_back(cp.asyncSend(vAddr, tag, context, data));
+            }
+
+            for(ZMQ::Event &e : recvEvents){
+                e.wait(strategy);
+                BOOST_REQUIRE(e.ready());
+            }
+
+            for(auto const &vAddr : context){
+                BOOST_REQUIRE_EQUAL(recv[vAddr][0], vAddr + static_cast<unsigned>(mode));
+            }
+
+            for(ZMQ::Event &e : sendEvents){
+                e.wait(strategy);
+            }
+        }
+
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE( striped_send_recv ){
+    // Test setup
+    ZMQConfig stripeConfig = zmqConfig;
+    stripeConfig.contextName     = "context_cp_stripe_test";
+    stripeConfig.ioThreads       = 2;
+    stripeConfig.streams         = 4;
+    stripeConfig.stripeThreshold = 1024;
+    ZMQ cp(stripeConfig);
+
+    // Test run, striped and small messages have to keep their order
+    {
+        const unsigned nElements = 100001;
+        const unsigned tag = 97;
+
+        ZMQ::Context context = cp.getGlobalContext();
+
+        for(unsigned run_i = 0; run_i < 10; ++run_i){
+            std::vector<ZMQ::Event> events;
+            std::vector<unsigned> large (nElements, 0);
+            std::vector<unsigned> small (1, run_i);
+            std::iota(large.begin(), large.end(), context.getVAddr() + run_i);
+
+            for(auto const &vAddr : context){
+                events.push_back(cp.asyncSend(vAddr, tag, context, large));
+                events.push_back(cp.asyncSend(vAddr, tag, context, small));
+            }
+
+            for(auto const &vAddr : context){
+                std::vector<unsigned> recvLarge (nElements, 0);
+                std::vector<unsigned> recvSmall (1, 0);
+                cp.recv(vAddr, tag, context, recvLarge);
+                cp.recv(vAddr, tag, context, recvSmall);
+
+                for(unsigned i = 0; i < recvLarge.size(); ++i){
+                    BOOST_REQUIRE_EQUAL(recvLarge[i], vAddr + run_i + i);
+                }
+                BOOST_REQUIRE_EQUAL(recvSmall[0], run_i);
+            }
+
+            for(ZMQ::Event &e : events){
+                e.wait();
+            }
+        }
+
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE( chunked_send_recv ){
+    // Test setup
+    ZMQConfig chunkConfig = zmqConfig;
+    chunkConfig.contextName = "context_cp_chunk_test";
+    chunkConfig.credits     = 2;
+    chunkConfig.chunkSize   = 1000;
+    chunkConfig.zeroCopy    = true;
+    ZMQ cp(chunkConfig);
+
+    // Test run, chunks are received into posted and not posted buffers
+    {
+        const unsigned nElements = 10001;
+        const unsigned tag = 96;
+
+        ZMQ::Context context = cp.getGlobalContext();
+
+        for(unsigned run_i = 0; run_i < 10; ++run_i){
+            std::vector<ZMQ::Event> sendEvents;
+            std::vector<ZMQ::Event> recvEvents;
+            std::vector<std::vector<unsigned> > posted (context.size(), std::vector<unsigned>(nElements, 0));
+            std::vector<unsigned> large (nElements, 0);
+            std::vector<unsigned> small (1, run_i);
+            std::iota(large.begin(), large.end(), context.getVAddr() + run_i);
+
+            for(auto const &vAddr : context){
+                recvEvents.push_back(cp.asyncRecv(vAddr, tag, context, posted[vAddr]));
+            }
+
+            for(auto const &vAddr : context){
+                sendEvents.push_back(cp.asyncSend(vAddr, tag, context, large));
+                sendEvents.push_back(cp.asyncSend(vAddr, tag, context, large));
+                sendEvents.push_back(cp.asyncSend(vAddr, tag, context, small));
+            }
+
+            for(ZMQ::Event &e : recvEvents){
+                e.wait();
+            }
+
+            for(auto const &vAddr : context){
+                std::vector<unsigned> recvLarge (nElements, 0);
+                std::vector<unsigned> recvSmall (1, 0);
+                cp.recv(vAddr, tag, context, recvLarge);
+                cp.recv(vAddr, tag, context, recvSmall);
+
+                for(unsigned i = 0; i < nElements; ++i){
+                    BOOST_REQUIRE_EQUAL(posted[vAddr][i], vAddr + run_i + i);
+                    BOOST_REQUIRE_EQUAL(recvLarge[i], vAddr + run_i + i);
+                }
+                BOOST_REQUIRE_EQUAL(recvSmall[0], run_i);
+            }
+
+            for(ZMQ::Event &e : sendEvents){
+                e.wait();
+            }
+        }
+
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE( striped_chunked_send_recv ){
+    // Test setup
+    ZMQConfig stripeConfig = zmqConfig;
+    stripeConfig.contextName     = "context_cp_stripe_chunk_test";
+    stripeConfig.ioThreads       = 2;
+    stripeConfig.streams         = 4;
+    stripeConfig.stripeThreshold = 1024;
+    stripeConfig.chunkSize       = 64 * 1024;
+    ZMQ cp(stripeConfig);
+
+    // Test run, every chunk of a message is striped on its own
+    {
+        const unsigned nElements = 1024 * 1024 + 1;
+        const unsigned tag = 95;
+
+        ZMQ::Context context = cp.getGlobalContext();
+
+        for(unsigned run_i = 0; run_i < 4; ++run_i){
+            std::vector<ZMQ::Event> events;
+            std::vector<unsigned> large (nElements, 0);
+            std::iota(large.begin(), large.end(), context.getVAddr() + run_i);
+
+            for(auto const &vAddr : context){
+                events.push_back(cp.asyncSend(vAddr, tag, context, large));
+            }
+
+            for(auto const &vAddr : context){
+                std::vector<unsigned> recvLarge (nElements, 0);
+                cp.recv(vAddr, tag, context, recvLarge);
+
+                for(unsigned i = 0; i < recvLarge.size(); ++i){
+                    BOOST_REQUIRE_EQUAL(recvLarge[i], vAddr + run_i + i);
+                }
+            }
+
+            for(ZMQ::Event &e : events){
+                e.wait();
+            }
+        }
+
+    }
+
+}
+
 BOOST_AUTO_TEST_CASE( send_recv_order ){
     hana::for_each(communicationPolicies, [](auto cpRef){
 	    // Test setup
@@ -374,6 +741,191 @@ BOOST_AUTO_TEST_CASE( send_recv_order ){
 }
 
 
+BOOST_AUTO_TEST_CASE( event_set ){
+    hana::for_each(communicationPolicies, [](auto cpRef){
+	    // Test setup
+	    using CP       = typename decltype(cpRef)::type;
+	    using Context  = typename CP::Context;
+	    using Event    = typename CP::Event;
+	    using EventSet = typename CP::EventSet;
+	    CP& cp = cpRef.get();
+
+	    // Test run
+	    {
+		Context context = cp.getGlobalContext();
+
+		const unsigned nElements = 10;
+		const unsigned tag = 93;
+
+		for(unsigned run_i = 0; run_i < 100; ++run_i){
+		    EventSet sendEvents;
+		    EventSet recvEvents;
+		    std::vector<std::vector<unsigned> > recv (context.size(), std::vector<unsigned>(nElements, 0));
+		    std::vector<unsigned> data (nElements, context.getVAddr() + run_i);
+
+		    for(auto const &vAddr : context){
+			recvEvents.push_back(cp.asyncRecv(vAddr, tag, context, recv[vAddr]));
+		    }
+
+		    for(auto const &vAddr : context){
+			sendEvents.push_back(cp.asyncSend(vAddr, tag, context, data));
+		    }
+
+		    BOOST_REQUIRE_EQUAL(recvEvents.size(), context.size());
+
+		    // Finished receives are taken out of the set one by one
+		    std::vector<Event> finished = recvEvents.testSome();
+		    size_t nFinished = finished.size();
+		    while(!recvEvents.empty()){
+			recvEvents.waitAny();
+			nFinished++;
+		    }
+		    BOOST_REQUIRE_EQUAL(nFinished, context.size());
+
+		    for(auto const &vAddr : context){
+			for(unsigned i = 0; i < nElements; ++i){
+			    BOOST_REQUIRE_EQUAL(recv[vAddr][i], vAddr + run_i);
+			}
+		    }
+
+		    sendEvents.waitAll();
+		    BOOST_REQUIRE(sendEvents.empty());
+
+		}
+
+	    }
+
+	});
+
+}
+
+
+BOOST_AUTO_TEST_CASE( struct_datatypes ){
+    static_assert(utils::IsRawBytes<Particle>::value, "Particle is sent as raw bytes");
+    static_assert(utils::IsRawBytes<std::tuple<unsigned, double> >::value, "tuple is sent as raw bytes");
+    static_assert(!utils::IsRawBytes<std::tuple<unsigned, std::string> >::value, "string is not sent as raw bytes");
+
+    // Padding of the struct is part of the extent
+    MPI_Aint lb     = 0;
+    MPI_Aint extent = 0;
+    MPI_Type_get_extent(graybat::communicationPolicy::bmpi::structDatatype<Particle>(), &lb, &extent);
+    BOOST_CHECK_EQUAL(extent, static_cast<MPI_Aint>(sizeof(Particle)));
+
+    hana::for_each(communicationPolicies, [](auto cpRef){
+	    // Test setup
+	    using CP      = typename decltype(cpRef)::type;
+	    using Context = typename CP::Context;
+	    using Event   = typename CP::Event;
+	    CP& cp = cpRef.get();
+
+	    // Test run
+	    {
+		Context context = cp.getGlobalContext();
+
+		const unsigned nElements = 100;
+		const unsigned tag = 95;
+
+		for(unsigned run_i = 0; run_i < 10; ++run_i){
+		    std::vector<Event> events;
+		    std::vector<Particle> particles(nElements);
+		    std::vector<std::tuple<unsigned, double> > tuples(nElements);
+
+		    for(unsigned i = 0; i < nElements; ++i){
+			particles[i].x    = i * 0.5;
+			particles[i].id   = context.getVAddr() + run_i;
+			particles[i].kind = 'a' + i % 26;
+			tuples[i] = std::make_tuple(context.getVAddr() + i, i * 0.25);
+		    }
+
+		    for(auto const &vAddr : context){
+			events.push_back(cp.asyncSend(vAddr, tag, context, particles));
+			events.push_back(cp.asyncSend(vAddr, tag + 1, context, tuples));
+		    }
+
+		    for(auto const &vAddr : context){
+			std::vector<Particle> recvParticles(nElements);
+			std::vector<std::tuple<unsigned, double> > recvTuples(nElements);
+			cp.recv(vAddr, tag, context, recvParticles);
+			cp.recv(vAddr, tag + 1, context, recvTuples);
+
+			for(unsigned i = 0; i < nElements; ++i){
+			    BOOST_REQUIRE_EQUAL(recvParticles[i].x, i * 0.5);
+			    BOOST_REQUIRE_EQUAL(recvParticles[i].id, vAddr + run_i);
+			    BOOST_REQUIRE_EQUAL(recvParticles[i].kind, 'a' + i % 26);
+			    BOOST_REQUIRE_EQUAL(std::get<0>(recvTuples[i]), vAddr + i);
+			    BOOST_REQUIRE_EQUAL(std::get<1>(recvTuples[i]), i * 0.25);
+			}
+		    }
+
+		    for(Event &e : events){
+			e.wait();
+		    }
+
+		}
+
+	    }
+
+	});
+
+}
+
+
+BOOST_AUTO_TEST_CASE( matched_recv_any ){
+    // Test setup
+    using Context = BMPI::Context;
+    using Event   = BMPI::Event;
+    BMPI& cp = bmpiCP;
+
+    // Test run
+    {
+	Context context = cp.getGlobalContext();
+
+	const unsigned tag = 94;
+
+	for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+	    std::vector<Event> events;
+	    // Message size depends on the sender
+	    std::vector<unsigned> data ((context.getVAddr() + 1) * 10, context.getVAddr() + run_i);
+
+	    for(auto const &vAddr : context){
+		events.push_back(cp.asyncSend(vAddr, tag, context, data));
+	    }
+
+	    for(unsigned msg_i = 0; msg_i < context.size(); ++msg_i){
+		std::vector<unsigned> recv;
+		Event e = cp.recv(context, recv);
+
+		BOOST_REQUIRE_EQUAL(recv.size(), (e.source() + 1) * 10);
+		for(unsigned i = 0; i < recv.size(); ++i){
+		    BOOST_REQUIRE_EQUAL(recv[i], e.source() + run_i);
+		}
+	    }
+
+	    for(auto const &vAddr : context){
+		events.push_back(cp.asyncSend(vAddr, tag, context, data));
+	    }
+
+	    unsigned nReceived = 0;
+	    while(nReceived < context.size()){
+		std::vector<unsigned> recv;
+		boost::optional<Event> e = cp.tryRecv(context, recv);
+		if(e){
+		    BOOST_REQUIRE_EQUAL(recv.size(), (e->source() + 1) * 10);
+		    nReceived++;
+		}
+	    }
+
+	    for(Event &e : events){
+		e.wait();
+	    }
+
+	}
+
+    }
+
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -680,12 +1232,11 @@ BOOST_AUTO_TEST_CASE( reduce ){
 
 
 
-BOOST_AUTO_TEST_CASE( broadcast ){
+BOOST_AUTO_TEST_CASE( reduce_scatter ){
     hana::for_each(communicationPolicies, [](auto cpRef){
 	    // Test setup
 	    using CP      = typename decltype(cpRef)::type;
 	    using Context = typename CP::Context;
-	    using Event   = typename CP::Event;	    	    
 	    CP& cp = cpRef.get();            
             Progress progress(cp);
 
@@ -695,25 +1246,48 @@ BOOST_AUTO_TEST_CASE( broadcast ){
                 Context context = cp.getGlobalContext();
 
                 const unsigned nElements = 10;
-                unsigned value = 9;
+                const unsigned nPeers    = context.size();
+                // Not known to MPI, thus reduced by ring in every policy
+                auto plus = [](unsigned const a, unsigned const b){ return a + b; };
 
                 for(unsigned run_i = 0; run_i < nRuns; ++run_i){
     
-                    std::vector<Event> events;
+                    // Block k contains k + 1
+                    std::vector<unsigned> send (nElements * nPeers);
+                    for(unsigned i = 0; i < send.size(); ++i){
+                        send[i] = i / nElements + 1;
+                    }
+                    std::vector<unsigned> recv (nElements, 0);
+                    std::vector<unsigned> recvRing (nElements, 0);
 
-                    std::vector<unsigned> data (nElements, value);
+                    cp.reduceScatter(context, std::plus<unsigned>(), send, recv);
+                    cp.reduceScatter(context, plus, send, recvRing);
 
-                    cp.broadcast(0, context, data);
+                    for(unsigned i = 0; i < nElements; ++i){
+                        BOOST_CHECK_EQUAL(recv[i], (context.getVAddr() + 1) * nPeers);
+                        BOOST_CHECK_EQUAL(recvRing[i], (context.getVAddr() + 1) * nPeers);
+                    }
 
-                    for(auto d : data){
-                        BOOST_CHECK_EQUAL(d, value);
+                    // Peer p receives p + 1 elements
+                    std::vector<unsigned> recvCount(nPeers);
+                    std::vector<unsigned> sendVar;
+                    for(unsigned peer = 0; peer < nPeers; ++peer){
+                        recvCount[peer] = peer + 1;
+                        sendVar.insert(sendVar.end(), peer + 1, peer);
                     }
+                    std::vector<unsigned> recvVar;
+                    std::vector<unsigned> recvVarRing;
 
-                    for(Event &e : events){
-                        e.wait();
-	    
+                    cp.reduceScatterVar(context, std::plus<unsigned>(), sendVar, recvVar, recvCount);
+                    cp.reduceScatterVar(context, plus, sendVar, recvVarRing, recvCount);
+
+                    BOOST_CHECK_EQUAL(recvVar.size(), context.getVAddr() + 1);
+                    BOOST_CHECK_EQUAL(recvVarRing.size(), context.getVAddr() + 1);
+                    for(unsigned i = 0; i < recvVar.size(); ++i){
+                        BOOST_CHECK_EQUAL(recvVar[i], context.getVAddr() * nPeers);
+                        BOOST_CHECK_EQUAL(recvVarRing[i], context.getVAddr() * nPeers);
                     }
-	
+
                     progress.print(nRuns, run_i);	
 
                 }
@@ -724,7 +1298,656 @@ BOOST_AUTO_TEST_CASE( broadcast ){
 
 }
 
+// Associative but not commutative, yields the operand of the lowest VAddr
+struct First {
+    unsigned operator()(unsigned const a, unsigned const) const {
+        return a;
+    }
+};
 
+BOOST_AUTO_TEST_CASE( ring_all_reduce ){
+    hana::for_each(communicationPolicies, [](auto cpRef){
+	    // Test setup
+	    using CP      = typename decltype(cpRef)::type;
+	    using Context = typename CP::Context;
+	    CP& cp = cpRef.get();            
 
+            // Test run
+            {
+    
+                Context context = cp.getGlobalContext();
+
+                // Large enough to be reduced by ring and not divisible by the number of peers
+                const unsigned nElements = CP::ringThreshold / sizeof(unsigned) * 2 + 1;
+
+                for(unsigned run_i = 0; run_i < 10; ++run_i){
+                    std::vector<unsigned> send (nElements);
+                    std::iota(send.begin(), send.end(), context.getVAddr() + run_i);
+                    std::vector<unsigned> recv (nElements, 0);
+
+                    cp.allReduce(context, std::plus<unsigned>(), send, recv);
+
+                    const unsigned nPeers = context.size();
+                    for(unsigned i = 0; i < nElements; ++i){
+                        BOOST_REQUIRE_EQUAL(recv[i], nPeers * (i + run_i) + nPeers * (nPeers - 1) / 2);
+                    }
+
+                    // Operands of an associative but non commutative op stay in VAddr order
+                    cp.allReduce(context, First(), send, recv);
+                    for(unsigned i = 0; i < nElements; ++i){
+                        BOOST_REQUIRE_EQUAL(recv[i], i + run_i);
+                    }
+
+                }
+		
+            }
+	    
+        });
+
+}
+
+BOOST_AUTO_TEST_CASE( broadcast ){
+    hana::for_each(communicationPolicies, [](auto cpRef){
+	    // Test setup
+	    using CP      = typename decltype(cpRef)::type;
+	    using Context = typename CP::Context;
+	    using Event   = typename CP::Event;	    	    
+	    CP& cp = cpRef.get();            
+            Progress progress(cp);
+
+            // Test run
+            {
+    
+                Context context = cp.getGlobalContext();
+
+                const unsigned nElements = 10;
+                unsigned value = 9;
+
+                for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+    
+                    std::vector<Event> events;
+
+                    std::vector<unsigned> data (nElements, value);
+
+                    cp.broadcast(0, context, data);
+
+                    for(auto d : data){
+                        BOOST_CHECK_EQUAL(d, value);
+                    }
+
+                    for(Event &e : events){
+                        e.wait();
+	    
+                    }
+	
+                    progress.print(nRuns, run_i);	
+
+                }
+		
+            }
+	    
+        });
+
+}
+
+
+
+
+BOOST_AUTO_TEST_CASE( segmented_broadcast ){
+    hana::for_each(communicationPolicies, [](auto cpRef){
+	    // Test setup
+	    using CP      = typename decltype(cpRef)::type;
+	    using Context = typename CP::Context;
+	    using VAddr   = typename CP::VAddr;
+	    CP& cp = cpRef.get();            
+
+            // Test run
+            {
+    
+                Context context = cp.getGlobalContext();
+
+                // Several segments, the last one is shorter
+                const unsigned nElements = CP::segmentSize / sizeof(unsigned) * 3 + 1;
+
+                for(VAddr root = 0; root < context.size(); ++root){
+                    std::vector<unsigned> data (nElements, 0);
+                    if(context.getVAddr() == root){
+                        std::iota(data.begin(), data.end(), root);
+                    }
+
+                    cp.broadcast(root, context, data);
+
+                    for(unsigned i = 0; i < nElements; ++i){
+                        BOOST_REQUIRE_EQUAL(data[i], root + i);
+                    }
+
+                }
+		
+            }
+	    
+        });
+
+}
+
+BOOST_AUTO_TEST_CASE( split_barrier ){
+    hana::for_each(communicationPolicies, [](auto cpRef){
+	    // Test setup
+	    using CP      = typename decltype(cpRef)::type;
+	    using Context = typename CP::Context;
+	    using Barrier = typename CP::Barrier;
+	    CP& cp = cpRef.get();            
+
+            // Test run
+            {
+    
+                Context context = cp.getGlobalContext();
+
+                for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+                    cp.synchronize(context);
+
+                    Barrier barrier = cp.asyncSynchronize(context);
+                    unsigned nLocalSteps = 0;
+                    while(!barrier.ready()){
+                        nLocalSteps++;
+                    }
+                    barrier.wait();
+                    BOOST_CHECK(barrier.ready());
+
+                }
+		
+            }
+	    
+        });
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+/*******************************************************************************
+ * Thread Peers Test Suites
+ ******************************************************************************/
+BOOST_AUTO_TEST_SUITE( graybat_cp_threads )
+
+using Threads       = graybat::communicationPolicy::Threads;
+using ThreadsConfig = Threads::Config;
+
+unsigned const nThreads = 4;
+
+/**
+ * @brief Runs *peer* in nThreads threads, each with its own policy
+ *        object, and returns the number of failed checks.
+ */
+template <typename T_Peer>
+unsigned runThreadPeers(std::string const contextName, T_Peer peer){
+    std::vector<unsigned> nErrors(nThreads, 0);
+    std::vector<std::thread> threads;
+
+    for(unsigned thread_i = 0; thread_i < nThreads; ++thread_i){
+        threads.emplace_back([&nErrors, &peer, contextName](){
+                Threads cp(ThreadsConfig({nThreads, contextName}));
+                nErrors.at(cp.getGlobalContext().getVAddr()) = peer(cp);
+            });
+    }
+
+    for(std::thread &thread : threads){
+        thread.join();
+    }
+
+    return std::accumulate(nErrors.begin(), nErrors.end(), 0U);
+
+}
+
+
+BOOST_AUTO_TEST_CASE( send_recv ){
+    unsigned nErrors = runThreadPeers("context_threads_send_recv", [](Threads &cp){
+            using Context = Threads::Context;
+            using Event   = Threads::Event;
+
+            unsigned errors = 0;
+            const unsigned nElements = 10;
+            const unsigned tag = 99;
+            Context context = cp.getGlobalContext();
+
+            for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+                std::vector<Event> events;
+
+                for(auto const &vAddr : context){
+                    std::vector<unsigned> data (nElements, 0);
+                    std::iota(data.begin(), data.end(), context.getVAddr());
+                    events.push_back(cp.asyncSend(vAddr, tag, context, data));
+                }
+
+                for(auto const &vAddr : context){
+                    std::vector<unsigned> recv (nElements, 0);
+                    if(vAddr % 2){
+                        cp.recv(vAddr, tag, context, recv);
+                    }
+                    else {
+                        cp.asyncRecv(vAddr, tag, context, recv).wait();
+                    }
+
+                    for(unsigned i = 0; i < recv.size(); ++i){
+                        errors += recv[i] != vAddr + i;
+                    }
+
+                }
+
+                for(Event &e : events){
+                    e.wait();
+                }
+
+            }
+
+            return errors;
+
+        });
+
+    BOOST_CHECK_EQUAL(nErrors, 0);
+
+}
+
+
+BOOST_AUTO_TEST_CASE( posted_recv_order ){
+    unsigned nErrors = runThreadPeers("context_threads_posted_recv_order", [](Threads &cp){
+            using Context = Threads::Context;
+            using Event   = Threads::Event;
+
+            unsigned errors = 0;
+            const unsigned tag = 99;
+            Context context = cp.getGlobalContext();
+            const unsigned left  = (context.getVAddr() + context.size() - 1) % context.size();
+            const unsigned right = (context.getVAddr() + 1) % context.size();
+
+            for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+                // Receives posted before (run_i even) or after (run_i odd)
+                // the messages arrived match them in FIFO order
+                std::array<unsigned, 1> first {{ 0 }};
+                std::array<unsigned, 1> second {{ 0 }};
+                std::vector<Event> events;
+
+                if(run_i % 2 == 0){
+                    events.push_back(cp.asyncRecv(left, tag, context, first));
+                    events.push_back(cp.asyncRecv(left, tag, context, second));
+                }
+                cp.synchronize(context);
+
+                cp.send(right, tag, context, std::array<unsigned, 1>{{ 1 }});
+                cp.send(right, tag, context, std::array<unsigned, 1>{{ 2 }});
+
+                if(run_i % 2){
+                    cp.synchronize(context);
+                    events.push_back(cp.asyncRecv(left, tag, context, first));
+                    events.push_back(cp.asyncRecv(left, tag, context, second));
+                }
+
+                events.back().wait();
+                events.front().wait();
+                errors += first[0] != 1;
+                errors += second[0] != 2;
+
+            }
+
+            return errors;
+
+        });
+
+    BOOST_CHECK_EQUAL(nErrors, 0);
+
+}
+
+BOOST_AUTO_TEST_CASE( split_collectives ){
+    unsigned nErrors = runThreadPeers("context_threads_collectives", [](Threads &cp){
+            using Context = Threads::Context;
+
+            unsigned errors = 0;
+            const unsigned nElements = 10;
+            Context context = cp.getGlobalContext();
+
+            for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+                std::vector<unsigned> send (nElements, context.getVAddr());
+                std::vector<unsigned> recv (nElements * context.size(), 0);
+                cp.allGather(context, send, recv);
+
+                for(unsigned i = 0; i < recv.size(); ++i){
+                    errors += recv[i] != i / nElements;
+                }
+
+                // Even peers form a new context, only the root holds the data
+                Context evenContext = cp.splitContext(context.getVAddr() % 2 == 0, context);
+                if(evenContext.valid()){
+                    errors += evenContext.size() != (context.size() + 1) / 2;
+                    const unsigned root = evenContext.vAddrOf(run_i % evenContext.size());
+                    std::vector<unsigned> data (nElements, evenContext.getVAddr() == root ? run_i : nRuns);
+                    cp.broadcast(root, evenContext, data);
+                    for(auto d : data){
+                        errors += d != run_i;
+                    }
+                }
+
+            }
+
+            return errors;
+
+        });
+
+    BOOST_CHECK_EQUAL(nErrors, 0);
+
+}
+
+BOOST_AUTO_TEST_CASE( sparse_collectives ){
+    unsigned nErrors = runThreadPeers("context_threads_sparse_collectives", [](Threads &cp){
+            using Context = Threads::Context;
+            using VAddr   = Threads::VAddr;
+
+            unsigned errors = 0;
+            const unsigned nElements = 10;
+            Context globalContext = cp.getGlobalContext();
+            const VAddr globalVAddr = globalContext.getVAddr();
+
+            // Split contexts keep the VAddrs of their parent,
+            // thus their members are not contiguous
+            Context oddContext  = cp.splitContext(globalVAddr % 2 == 1, globalContext);
+            Context holeContext = cp.splitContext(globalVAddr != 2, globalContext);
+            std::vector<Context> contexts;
+            for(Context const &context : {oddContext, holeContext}){
+                if(context.valid()){
+                    contexts.push_back(context);
+                }
+            }
+
+            for(Context const &context : contexts){
+                const unsigned nPeers = context.size();
+                const unsigned rank   = context.rankOf(context.getVAddr());
+
+                for(unsigned root_i = 0; root_i < nPeers; ++root_i){
+                    const VAddr root = context.vAddrOf(root_i);
+
+                    std::vector<unsigned> send (nElements, rank + 1);
+                    std::vector<unsigned> recv (nElements, 0);
+                    cp.reduce(root, context, std::plus<unsigned>(), send, recv);
+                    if(context.getVAddr() == root){
+                        for(auto d : recv){
+                            errors += d != nPeers * (nPeers + 1) / 2;
+                        }
+                    }
+
+                    std::vector<unsigned> data (nElements, context.getVAddr() == root ? root : nThreads);
+                    cp.broadcast(root, context, data);
+                    for(auto d : data){
+                        errors += d != root;
+                    }
+
+                    std::vector<unsigned> gathered (nElements * nPeers, nThreads);
+                    cp.gather(root, context, std::vector<unsigned>(nElements, rank), gathered);
+                    if(context.getVAddr() == root){
+                        for(unsigned i = 0; i < gathered.size(); ++i){
+                            errors += gathered[i] != i / nElements;
+                        }
+                    }
+
+                    // Pipelined in segments along the members
+                    std::vector<unsigned> largeData (Threads::segmentSize / sizeof(unsigned) * 2 + 1, context.getVAddr() == root ? root : nThreads);
+                    cp.broadcast(root, context, largeData);
+                    for(auto d : largeData){
+                        errors += d != root;
+                    }
+
+                    std::vector<unsigned> scatterData;
+                    if(context.getVAddr() == root){
+                        for(unsigned i = 0; i < nElements * nPeers; ++i){
+                            scatterData.push_back(i / nElements);
+                        }
+                    }
+                    std::vector<unsigned> block (nElements, nPeers);
+                    cp.scatter(root, context, scatterData, block);
+                    for(auto d : block){
+                        errors += d != rank;
+                    }
+
+                }
+
+                std::vector<unsigned> send (nElements, rank + 1);
+                std::vector<unsigned> recv (nElements, 0);
+                cp.allReduce(context, std::plus<unsigned>(), send, recv);
+                for(auto d : recv){
+                    errors += d != nPeers * (nPeers + 1) / 2;
+                }
+
+                std::vector<unsigned> sendLarge (Threads::ringThreshold / sizeof(unsigned) + nPeers + 1, rank + 1);
+                std::vector<unsigned> recvLarge (sendLarge.size(), 0);
+                cp.allReduce(context, std::plus<unsigned>(), sendLarge, recvLarge);
+                for(auto d : recvLarge){
+                    errors += d != nPeers * (nPeers + 1) / 2;
+                }
+
+                std::vector<unsigned> sendBlocks (nElements * nPeers);
+                for(unsigned i = 0; i < sendBlocks.size(); ++i){
+                    sendBlocks[i] = rank + i / nElements;
+                }
+                cp.reduceScatter(context, std::plus<unsigned>(), sendBlocks, recv);
+                for(auto d : recv){
+                    errors += d != nPeers * (nPeers - 1) / 2 + nPeers * rank;
+                }
+
+                std::vector<unsigned> gathered (nElements * nPeers, nThreads);
+                cp.allGather(context, std::vector<unsigned>(nElements, rank), gathered);
+                for(unsigned i = 0; i < gathered.size(); ++i){
+                    errors += gathered[i] != i / nElements;
+                }
+
+                std::vector<unsigned> recvCount;
+                std::vector<unsigned> gatheredVar;
+                cp.allGatherVar(context, std::vector<unsigned>(rank + 1, rank), gatheredVar, recvCount);
+                unsigned i = 0;
+                for(unsigned peer = 0; peer < nPeers; ++peer){
+                    for(unsigned j = 0; j < peer + 1; ++j){
+                        errors += gatheredVar.at(i++) != peer;
+                    }
+                }
+
+                std::vector<unsigned> scattered (nElements * nPeers);
+                for(unsigned i = 0; i < scattered.size(); ++i){
+                    scattered[i] = rank * nPeers + i / nElements;
+                }
+                std::vector<unsigned> transposed (nElements * nPeers, nPeers * nPeers);
+                cp.allScatter(context, scattered, transposed);
+                for(unsigned i = 0; i < transposed.size(); ++i){
+                    errors += transposed[i] != (i / nElements) * nPeers + rank;
+                }
+
+                cp.synchronize(context);
+                cp.asyncSynchronize(context).wait();
+
+            }
+
+            return errors;
+
+        });
+
+    BOOST_CHECK_EQUAL(nErrors, 0);
+
+}
+
+BOOST_AUTO_TEST_CASE( dissemination_barrier ){
+    static std::atomic<unsigned> nArrived(0);
+
+    unsigned nErrors = runThreadPeers("context_threads_barrier", [](Threads &cp){
+            using Context = Threads::Context;
+
+            unsigned errors = 0;
+            Context globalContext = cp.getGlobalContext();
+
+            // A power of two and a non power of two number of peers
+            Context oddContext = cp.splitContext(globalContext.getVAddr() < nThreads - 1, globalContext);
+
+            for(unsigned run_i = 0; run_i < nRuns; ++run_i){
+                // No peer leaves a barrier before all peers arrived
+                nArrived++;
+                cp.synchronize(globalContext);
+                errors += nArrived < (2 * run_i + 1) * nThreads;
+
+                nArrived++;
+                Threads::Barrier barrier = cp.asyncSynchronize(globalContext);
+                while(!barrier.ready()){
+                    std::this_thread::yield();
+                }
+                errors += nArrived < (2 * run_i + 2) * nThreads;
+
+                if(oddContext.valid()){
+                    cp.asyncSynchronize(oddContext).wait();
+
+                    // A dropped barrier is finished by its destructor
+                    cp.asyncSynchronize(oddContext);
+                }
+
+            }
+
+            return errors;
+
+        });
+
+    BOOST_CHECK_EQUAL(nErrors, 0);
+
+}
+
+BOOST_AUTO_TEST_CASE( tree_collectives ){
+    unsigned nErrors = runThreadPeers("context_threads_tree_collectives", [](Threads &cp){
+            using Context = Threads::Context;
+            using VAddr   = Threads::VAddr;
+
+            unsigned errors = 0;
+            const unsigned nElements = 10;
+            Context globalContext = cp.getGlobalContext();
+
+            // A power of two and a non power of two number of peers
+            Context oddContext = cp.splitContext(globalContext.getVAddr() < nThreads - 1, globalContext);
+            std::vector<Context> contexts{globalContext};
+            if(oddContext.valid()){
+                contexts.push_back(oddContext);
+            }
+
+            for(Context const &context : contexts){
+                const unsigned nPeers = context.size();
+                const unsigned vAddr  = context.getVAddr();
+
+                for(VAddr root = 0; root < nPeers; ++root){
+                    std::vector<unsigned> send (nElements, vAddr + 1);
+                    std::vector<unsigned> recv (nElements, 0);
+
+                    cp.reduce(root, context, std::plus<unsigned>(), send, recv);
+                    if(vAddr == root){
+                        for(auto d : recv){
+                            errors += d != nPeers * (nPeers + 1) / 2;
+                        }
+                    }
+
+                    std::vector<unsigned> data (nElements, vAddr == root ? root : nPeers);
+                    cp.broadcast(root, context, data);
+                    for(auto d : data){
+                        errors += d != root;
+                    }
+
+                    // Pipelined in segments, the last one is shorter
+                    std::vector<unsigned> largeData (Threads::segmentSize / sizeof(unsigned) * 3 + 1, vAddr == root ? root : nPeers);
+                    cp.broadcast(root, context, largeData);
+                    for(auto d : largeData){
+                        errors += d != root;
+                    }
+
+                    std::vector<unsigned> scatterData;
+                    if(vAddr == root){
+                        for(unsigned i = 0; i < nElements * nPeers; ++i){
+                            scatterData.push_back(i / nElements);
+                        }
+                    }
+                    std::vector<unsigned> block (nElements, nPeers);
+                    cp.scatter(root, context, scatterData, block);
+                    for(auto d : block){
+                        errors += d != vAddr;
+                    }
+
+                    // Gathered blocks are received in place
+                    std::vector<unsigned> gatheredRoot (nElements * nPeers, nPeers);
+                    cp.gather(root, context, std::vector<unsigned>(nElements, vAddr), gatheredRoot);
+                    if(vAddr == root){
+                        for(unsigned i = 0; i < gatheredRoot.size(); ++i){
+                            errors += gatheredRoot[i] != i / nElements;
+                        }
+                    }
+
+                    std::vector<unsigned> recvCount;
+                    std::vector<unsigned> gatheredVar;
+                    cp.gatherVar(root, context, std::vector<unsigned>(vAddr + 1, vAddr), gatheredVar, recvCount);
+                    if(vAddr == root){
+                        unsigned i = 0;
+                        for(unsigned peer = 0; peer < nPeers; ++peer){
+                            for(unsigned j = 0; j < peer + 1; ++j){
+                                errors += gatheredVar.at(i++) != peer;
+                            }
+                        }
+                    }
+
+                }
+
+                std::vector<unsigned> send (nElements, vAddr + 1);
+                std::vector<unsigned> recv (nElements, 0);
+                cp.allReduce(context, std::plus<unsigned>(), send, recv);
+                for(auto d : recv){
+                    errors += d != nPeers * (nPeers + 1) / 2;
+                }
+
+                std::vector<unsigned> sendLarge (Threads::ringThreshold / sizeof(unsigned) + nPeers + 1, vAddr + 1);
+                std::vector<unsigned> recvLarge (sendLarge.size(), 0);
+                cp.allReduce(context, std::plus<unsigned>(), sendLarge, recvLarge);
+                for(auto d : recvLarge){
+                    errors += d != nPeers * (nPeers + 1) / 2;
+                }
+
+                std::vector<unsigned> sendBlocks (nElements * nPeers);
+                for(unsigned i = 0; i < sendBlocks.size(); ++i){
+                    sendBlocks[i] = vAddr + i / nElements;
+                }
+                cp.reduceScatter(context, std::plus<unsigned>(), sendBlocks, recv);
+                for(auto d : recv){
+                    errors += d != nPeers * (nPeers - 1) / 2 + nPeers * vAddr;
+                }
+
+                std::vector<unsigned> gathered (nElements * nPeers, nPeers);
+                cp.allGather(context, std::vector<unsigned>(nElements, vAddr), gathered);
+                for(unsigned i = 0; i < gathered.size(); ++i){
+                    errors += gathered[i] != i / nElements;
+                }
+
+                std::vector<unsigned> recvCount;
+                std::vector<unsigned> gatheredVar;
+                cp.allGatherVar(context, std::vector<unsigned>(vAddr + 1, vAddr), gatheredVar, recvCount);
+                unsigned i = 0;
+                for(unsigned peer = 0; peer < nPeers; ++peer){
+                    for(unsigned j = 0; j < peer + 1; ++j){
+                        errors += gatheredVar.at(i++) != peer;
+                    }
+                }
+
+                std::vector<unsigned> scattered (nElements * nPeers);
+                for(unsigned i = 0; i < scattered.size(); ++i){
+                    scattered[i] = vAddr * nPeers + i / nElements;
+                }
+                std::vector<unsigned> transposed (nElements * nPeers, nPeers * nPeers);
+                cp.allScatter(context, scattered, transposed);
+                for(unsigned i = 0; i < transposed.size(); ++i){
+                    errors += transposed[i] != (i / nElements) * nPeers + vAddr;
+                }
+
+            }
+
+            return errors;
+
+        });
+
+    BOOST_CHECK_EQUAL(nErrors, 0);
+
+}
 
 BOOST_AUTO_TEST_SUITE_END()
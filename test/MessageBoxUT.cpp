@@ -0,0 +1,173 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// BOOST
+#include <boost/test/unit_test.hpp>
+
+// STL
+#include <vector>  /* std::vector */
+#include <thread>  /* std::thread */
+#include <atomic>  /* std::atomic */
+#include <chrono>  /* std::chrono::milliseconds */
+#include <tuple>   /* std::tuple, std::get */
+
+// GRAYBAT
+#include <graybat/utils/MultiKeyMap.hpp>
+
+/***************************************************************************
+ * Test Suites
+ ****************************************************************************/
+BOOST_AUTO_TEST_SUITE( graybat_message_box )
+
+// Message type, context, vAddr and tag as used by the socket inboxes
+using Value      = std::vector<char>;
+using Keys       = std::tuple<unsigned, unsigned, unsigned, unsigned>;
+using MessageBox = utils::MessageBox<Value, unsigned, unsigned, unsigned, unsigned>;
+
+const std::chrono::milliseconds blockTime(50);
+
+/***************************************************************************
+ * Test Cases
+ ****************************************************************************/
+
+BOOST_AUTO_TEST_CASE( full_key_waiter ){
+    const unsigned nWaiters = 32;
+    MessageBox messageBox(1024);
+    std::atomic<unsigned> nReceived(0);
+    std::atomic<unsigned> nErrors(0);
+    std::vector<std::thread> waiters;
+
+    // Waiters on distinct vAddrs, thus they spread over the shards
+    for(unsigned vAddr = 0; vAddr < nWaiters; ++vAddr){
+        waiters.emplace_back([&messageBox, &nReceived, &nErrors, vAddr]{
+                Value value = messageBox.waitDequeue(0, 1, vAddr, 2);
+                nErrors += value.size() != vAddr + 1;
+                nReceived++;
+            });
+    }
+
+    std::this_thread::sleep_for(blockTime);
+    BOOST_CHECK_EQUAL(nReceived, 0);
+
+    for(unsigned vAddr = nWaiters; vAddr-- > 0;){
+        messageBox.enqueue(Value(vAddr + 1, 'x'), 0, 1, vAddr, 2);
+    }
+
+    for(std::thread &waiter : waiters){
+        waiter.join();
+    }
+
+    BOOST_CHECK_EQUAL(nReceived, nWaiters);
+    BOOST_CHECK_EQUAL(nErrors, 0);
+
+}
+
+BOOST_AUTO_TEST_CASE( any_prefix_waiter ){
+    const unsigned nContexts = 2;
+    const unsigned nValues   = 256;
+    MessageBox messageBox(1024 * 1024);
+    std::vector<unsigned> nErrors(nContexts, 0);
+    std::vector<std::thread> waiters;
+
+    // One waiter per context takes the values of any vAddr and tag
+    for(unsigned context = 0; context < nContexts; ++context){
+        waiters.emplace_back([&messageBox, &nErrors, context, nValues]{
+                std::vector<unsigned> seen(nValues, 0);
+                for(unsigned value_i = 0; value_i < nValues; ++value_i){
+                    Keys keys;
+                    Value value = messageBox.waitDequeue(keys, 0u, context);
+                    nErrors[context] += std::get<0>(keys) != 0;
+                    nErrors[context] += std::get<1>(keys) != context;
+                    nErrors[context] += value.size() != std::get<2>(keys) * nValues + std::get<3>(keys) + 1;
+                    seen.at(std::get<3>(keys))++;
+                }
+                for(unsigned count : seen){
+                    nErrors[context] += count != 1;
+                }
+            });
+    }
+
+    std::this_thread::sleep_for(blockTime);
+
+    // Values of the contexts interleaved and spread over all shards,
+    // values of another message type must stay in the box
+    for(unsigned tag = 0; tag < nValues; ++tag){
+        const unsigned vAddr = tag % 7;
+        for(unsigned context = 0; context < nContexts; ++context){
+            messageBox.enqueue(Value(vAddr * nValues + tag + 1, 'x'), 0, context, vAddr, tag);
+        }
+        messageBox.enqueue(Value(1, 'x'), 1, 0, vAddr, tag);
+    }
+
+    for(std::thread &waiter : waiters){
+        waiter.join();
+    }
+
+    for(unsigned context = 0; context < nContexts; ++context){
+        BOOST_CHECK_EQUAL(nErrors[context], 0);
+    }
+
+    bool result = false;
+    messageBox.tryDequeue(result, 0, 0, 0, 0);
+    BOOST_CHECK(!result);
+    messageBox.tryDequeue(result, 1, 0, 0, 0);
+    BOOST_CHECK(result);
+
+}
+
+BOOST_AUTO_TEST_CASE( reserve_back_pressure ){
+    const size_t maxBufferSize = 16;
+    MessageBox messageBox(maxBufferSize);
+    std::atomic<bool> largeEnqueued(false);
+    std::atomic<bool> smallEnqueued(false);
+
+    messageBox.enqueue(Value(maxBufferSize / 2, 'a'), 0, 0, 0, 0);
+
+    // Does not fit next to the queued value
+    std::thread largeWriter([&messageBox, &largeEnqueued, maxBufferSize]{
+            messageBox.enqueue(Value(maxBufferSize * 4, 'b'), 0, 0, 1, 0);
+            largeEnqueued = true;
+        });
+
+    std::this_thread::sleep_for(blockTime);
+    BOOST_CHECK(!largeEnqueued);
+
+    // The value larger than the buffer is taken once the buffer is empty
+    BOOST_CHECK_EQUAL(messageBox.waitDequeue(0, 0, 0, 0).size(), maxBufferSize / 2);
+    largeWriter.join();
+    BOOST_CHECK(largeEnqueued);
+
+    // Does not fit next to the large value
+    std::thread smallWriter([&messageBox, &smallEnqueued]{
+            messageBox.enqueue(Value(1, 'c'), 0, 0, 2, 0);
+            smallEnqueued = true;
+        });
+
+    std::this_thread::sleep_for(blockTime);
+    BOOST_CHECK(!smallEnqueued);
+
+    BOOST_CHECK_EQUAL(messageBox.waitDequeue(0, 0, 1, 0).size(), maxBufferSize * 4);
+    smallWriter.join();
+    BOOST_CHECK(smallEnqueued);
+    BOOST_CHECK_EQUAL(messageBox.waitDequeue(0, 0, 2, 0).size(), 1);
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -60,7 +60,7 @@ ZMQConfig zmqConfig = {"tcp://127.0.0.1:5000",
                        static_cast<size_t>(std::stoi(std::getenv("OMPI_COMM_WORLD_SIZE"))),
 					   "context_vertex_test"};
 
-BMPIConfig bmpiConfig;
+BMPIConfig bmpiConfig = {boost::mpi::threading::multiple};
 
 ZMQCage zmqCage(zmqConfig);
 BMPICage bmpiCage(bmpiConfig);